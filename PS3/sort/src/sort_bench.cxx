@@ -0,0 +1,487 @@
+// Harvard CS50 sort — automated algorithm fingerprinting harness in C++
+#include <fcntl.h>
+#include <getopt.h>
+#include <sched.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern char** environ;
+
+////
+/// This harness replaces the manual `hyperfine` runs described in README.md.
+/// It runs every sort executable over the (order x size) matrix of CS50 input files, takes the median
+/// CPU time of several repetitions, fits each order's timings to the n, n log n and n² complexity models and
+/// matches the resulting fingerprint against the known bubble, selection and merge sort signatures.
+//
+namespace sort_bench
+{
+enum class InputOrder : std::uint8_t
+{
+  RANDOM,
+  SORTED,
+  REVERSED
+};
+
+enum class Complexity : std::uint8_t
+{
+  LINEAR,
+  LINEARITHMIC,
+  QUADRATIC
+};
+
+constexpr std::array Input_Orders = {InputOrder::RANDOM, InputOrder::SORTED, InputOrder::REVERSED};
+constexpr std::array Input_Sizes = {5000ul, 10000ul, 50000ul};
+constexpr std::array Complexities = {Complexity::LINEAR, Complexity::LINEARITHMIC, Complexity::QUADRATIC};
+
+constexpr std::size_t MIN_REPETITIONS = 5;   // fewer samples cannot estimate the run-to-run noise
+constexpr double MIN_RELATIVE_NOISE = 0.01;  // timer resolution and scheduling jitter
+constexpr double MIN_SIGNAL_TO_NOISE = 5.0;  // growth across sizes, in units of run-to-run noise
+constexpr double MIN_FIT_SCORE = 0.9;        // below this the best signature is reported as inconclusive
+
+constexpr auto InputOrder_to_string_view = [](const InputOrder Order) noexcept -> std::string_view {
+  switch (Order) {
+    case InputOrder::RANDOM:
+      return "random";
+    case InputOrder::SORTED:
+      return "sorted";
+    case InputOrder::REVERSED:
+      return "reversed";
+  }
+  return "unknown";
+};
+
+constexpr auto Complexity_to_string_view = [](const Complexity Model) noexcept -> std::string_view {
+  switch (Model) {
+    case Complexity::LINEAR:
+      return "n";
+    case Complexity::LINEARITHMIC:
+      return "n log n";
+    case Complexity::QUADRATIC:
+      return "n^2";
+  }
+  return "unknown";
+};
+
+// Growth function of each complexity model
+constexpr auto growth = [](const Complexity Model, const double N) noexcept {
+  switch (Model) {
+    case Complexity::LINEAR:
+      return N;
+    case Complexity::LINEARITHMIC:
+      return N * std::log2(N);
+    case Complexity::QUADRATIC:
+      return N * N;
+  }
+  return N;
+};
+
+////
+/// Known algorithm signatures: expected complexity on random, sorted and reversed input, in that order.
+/// Bubble sort with early exit is linear on sorted input, selection sort is quadratic regardless of order
+/// and merge sort is n log n regardless of order.
+//
+struct AlgorithmSignature
+{
+  std::string_view Name;
+  std::array<Complexity, Input_Orders.size()> Expected;
+};
+
+constexpr std::array Algorithm_Signatures = {
+    AlgorithmSignature{"bubble sort", {Complexity::QUADRATIC, Complexity::LINEAR, Complexity::QUADRATIC}},
+    AlgorithmSignature{"selection sort", {Complexity::QUADRATIC, Complexity::QUADRATIC, Complexity::QUADRATIC}},
+    AlgorithmSignature{"merge sort", {Complexity::LINEARITHMIC, Complexity::LINEARITHMIC, Complexity::LINEARITHMIC}}};
+
+struct Options
+{
+  std::filesystem::path Data_Dir = "CS50 FIles";
+  std::vector<std::filesystem::path> Executables;
+  std::size_t Repetitions = 5;
+  std::size_t Warmups = 1;
+  int Cpu = -1;      // -1: do not pin
+  bool Cold = false;  // drop the input file from the page cache before every run
+  std::optional<std::filesystem::path> Csv_File;
+};
+
+struct Timing
+{
+  double Wall_Seconds;
+  double Cpu_Seconds;
+};
+
+struct Measurement
+{
+  std::string Executable;
+  InputOrder Order;
+  std::size_t Size;
+  std::size_t Repetition;
+  Timing Time;
+};
+
+struct ModelFit
+{
+  Complexity Model;
+  double Scale;     // seconds per unit of growth
+  double Overhead;  // constant process start-up cost in seconds
+  double Residual;  // weighted (relative) residual sum of squares
+  double Weight;    // Akaike weight: support for this model relative to the others, not a calibrated probability
+};
+
+////
+/// Pin this process (and therefore every child it spawns) to a single CPU
+//
+auto pin_to_cpu(const int Cpu) noexcept -> bool
+{
+  cpu_set_t Cpu_Set;
+  CPU_ZERO(&Cpu_Set);
+  CPU_SET(Cpu, &Cpu_Set);
+  return sched_setaffinity(0, sizeof(Cpu_Set), &Cpu_Set) == 0;
+}
+
+////
+/// Ask the kernel to evict a file from the page cache so the next run reads it cold
+//
+auto drop_from_page_cache(const std::filesystem::path& File) noexcept -> void
+{
+  if (const int Fd = open(File.c_str(), O_RDONLY); Fd >= 0) {
+    fdatasync(Fd);
+    posix_fadvise(Fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(Fd);
+  }
+}
+
+////
+/// Run Executable on Input_File once, discarding its output, and return wall and CPU time of the child
+//
+auto time_run(const std::filesystem::path& Executable, const std::filesystem::path& Input_File)
+    -> std::optional<Timing>
+{
+  posix_spawn_file_actions_t File_Actions;
+  posix_spawn_file_actions_init(&File_Actions);
+  posix_spawn_file_actions_addopen(&File_Actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+  std::string Exe_Arg = Executable.string();
+  std::string Input_Arg = Input_File.string();
+  std::array<char*, 3> Argv = {Exe_Arg.data(), Input_Arg.data(), nullptr};
+
+  pid_t Child = 0;
+  const auto Start = std::chrono::steady_clock::now();
+  const int Spawn_Status = posix_spawn(&Child, Exe_Arg.c_str(), &File_Actions, nullptr, Argv.data(), environ);
+  posix_spawn_file_actions_destroy(&File_Actions);
+  if (Spawn_Status != 0) [[unlikely]] { return std::nullopt; }
+
+  int Wait_Status = 0;
+  rusage Usage = {};
+  if (wait4(Child, &Wait_Status, 0, &Usage) != Child) [[unlikely]] { return std::nullopt; }
+  const auto Stop = std::chrono::steady_clock::now();
+
+  if (!WIFEXITED(Wait_Status) || WEXITSTATUS(Wait_Status) != 0) [[unlikely]] { return std::nullopt; }
+
+  auto timeval_to_seconds = [](const timeval& Value) {
+    return static_cast<double>(Value.tv_sec) + static_cast<double>(Value.tv_usec) / 1e6;
+  };
+  return Timing{std::chrono::duration<double>(Stop - Start).count(),
+                timeval_to_seconds(Usage.ru_utime) + timeval_to_seconds(Usage.ru_stime)};
+}
+
+auto median(std::vector<double> Values) -> double
+{
+  std::ranges::sort(Values);
+  const auto Mid = Values.size() / 2;
+  return Values.size() % 2 != 0 ? Values[Mid] : (Values[Mid - 1] + Values[Mid]) / 2.0;
+}
+
+////
+/// Run-to-run noise of Values relative to their median: the median absolute deviation, scaled to estimate a
+/// standard deviation
+//
+auto relative_spread(const std::vector<double>& Values, const double Median) -> double
+{
+  constexpr double MAD_TO_SIGMA = 1.4826;
+  std::vector<double> Deviations;
+  Deviations.reserve(Values.size());
+  for (const auto Value : Values) { Deviations.push_back(std::abs(Value - Median)); }
+  return MAD_TO_SIGMA * median(std::move(Deviations)) / std::max(Median, 1e-6);
+}
+
+////
+/// Fit t = Overhead + Scale * growth(n) by least squares, weighting every point by 1/t² so that the
+/// small and large inputs count equally (relative error). Both parameters are constrained to be non-negative.
+//
+auto fit_model(const Complexity Model, const std::vector<std::pair<double, double>>& Points) -> ModelFit
+{
+  double Sw = 0.0, Sf = 0.0, St = 0.0, Sff = 0.0, Sft = 0.0;
+  for (const auto& [N, T] : Points) {
+    const double W = 1.0 / std::max(T * T, 1e-12);
+    const double F = growth(Model, N);
+    Sw += W;
+    Sf += W * F;
+    St += W * T;
+    Sff += W * F * F;
+    Sft += W * F * T;
+  }
+
+  double Scale = (Sw * Sft - Sf * St) / (Sw * Sff - Sf * Sf);
+  double Overhead = (St - Scale * Sf) / Sw;
+  if (Overhead < 0.0) {
+    // No negative start-up cost: refit through the origin
+    Overhead = 0.0;
+    Scale = Sft / Sff;
+  }
+  if (Scale < 0.0) {
+    // Timings do not grow at all: constant model
+    Scale = 0.0;
+    Overhead = St / Sw;
+  }
+
+  double Residual = 0.0;
+  for (const auto& [N, T] : Points) {
+    const double Relative_Error = (T - Overhead - Scale * growth(Model, N)) / std::max(T, 1e-6);
+    Residual += Relative_Error * Relative_Error;
+  }
+  return ModelFit{Model, Scale, Overhead, Residual, 0.0};
+}
+
+////
+/// Fit all models and turn their residuals into Akaike weights
+//
+// AIC = n ln(RSS / n) + 2k. Every model has the same k = 2 parameters (Overhead and Scale), so the penalty cancels
+// and the weight exp(-ΔAIC / 2) reduces to (RSS / RSS_min)^(-n/2). With n = 3 sizes each fit keeps a single degree
+// of freedom, so a residual below the measurement noise says nothing: every RSS is floored at n·σ², where σ is the
+// relative run-to-run noise (at least MIN_RELATIVE_NOISE). The weights rank the models; they are not probabilities.
+//
+auto fit_all_models(const std::vector<std::pair<double, double>>& Points, const double Relative_Noise)
+    -> std::array<ModelFit, Complexities.size()>
+{
+  std::array<ModelFit, Complexities.size()> Fits = {};
+  std::ranges::transform(Complexities, Fits.begin(), [&](const Complexity Model) { return fit_model(Model, Points); });
+
+  const auto N = static_cast<double>(Points.size());
+  const double Sigma = std::max(Relative_Noise, MIN_RELATIVE_NOISE);
+  const double Residual_Floor = N * Sigma * Sigma;
+  auto floored = [&](const ModelFit& Fit) { return std::max(Fit.Residual, Residual_Floor); };
+
+  const double Min_Residual = floored(std::ranges::min(Fits, {}, floored));
+  double Total = 0.0;
+  for (auto& Fit : Fits) {
+    Fit.Weight = std::pow(floored(Fit) / Min_Residual, -N / 2.0);
+    Total += Fit.Weight;
+  }
+  for (auto& Fit : Fits) { Fit.Weight /= Total; }
+  return Fits;
+}
+
+////
+/// Whether the timings of one order grow across the sizes by clearly more than they vary between repetitions
+//
+// When every run takes a few milliseconds, process start-up and I/O dominate and the differences between sizes are
+// mostly noise; any model then fits about as well as any other, and the weights say nothing.
+//
+auto rises_above_noise(const std::vector<std::pair<double, double>>& Points, const double Relative_Noise) -> bool
+{
+  const auto [Min_Time, Max_Time] = std::ranges::minmax(Points | std::views::values);
+  return (Max_Time - Min_Time) / std::max(Min_Time, 1e-6) >=
+         MIN_SIGNAL_TO_NOISE * std::max(Relative_Noise, MIN_RELATIVE_NOISE);
+}
+
+auto print_usage() -> void
+{
+  std::println("Usage: ./sort_bench [-d data_dir] [-r repetitions] [-w warmups] [-p cpu] [-C] [-o timings.csv] "
+               "[sort ...]");
+  std::println("  -d  directory holding random/sorted/reversed{{5000,10000,50000}}.txt (default \"CS50 FIles\")");
+  std::println("  -r  measured repetitions per input (default and minimum {})", MIN_REPETITIONS);
+  std::println("  -w  unmeasured warm-up runs per input (default 1)");
+  std::println("  -p  pin the harness and all runs to this CPU");
+  std::println("  -C  cold cache: evict the input file from the page cache before every run");
+  std::println("  -o  write raw timings as CSV to this file instead of stdout");
+  std::println("  sort executables default to sort1 sort2 sort3 inside data_dir");
+}
+
+auto parse_options(int argc, char* argv[]) -> std::optional<Options>
+{
+  Options Parsed;
+  auto string_to_size_t = [](const char* Text) -> std::optional<std::size_t> {
+    char* End = nullptr;
+    const auto Value = std::strtoul(Text, &End, 10);
+    return End != Text && *End == '\0' ? std::optional{static_cast<std::size_t>(Value)} : std::nullopt;
+  };
+
+  for (int Option = 0; (Option = getopt(argc, argv, "d:r:w:p:Co:h")) != -1;) {
+    switch (Option) {
+      case 'd':
+        Parsed.Data_Dir = optarg;
+        break;
+      case 'r': {
+        const auto Value = string_to_size_t(optarg);
+        if (!Value || *Value < MIN_REPETITIONS) { return std::nullopt; }
+        Parsed.Repetitions = *Value;
+      } break;
+      case 'w': {
+        const auto Value = string_to_size_t(optarg);
+        if (!Value) { return std::nullopt; }
+        Parsed.Warmups = *Value;
+      } break;
+      case 'p': {
+        const auto Value = string_to_size_t(optarg);
+        if (!Value || *Value >= CPU_SETSIZE) { return std::nullopt; }
+        Parsed.Cpu = static_cast<int>(*Value);
+      } break;
+      case 'C':
+        Parsed.Cold = true;
+        break;
+      case 'o':
+        Parsed.Csv_File = optarg;
+        break;
+      default:
+        return std::nullopt;
+    }
+  }
+
+  for (int Arg = optind; Arg < argc; ++Arg) { Parsed.Executables.emplace_back(argv[Arg]); }
+  if (Parsed.Executables.empty()) {
+    for (const auto* Name : {"sort1", "sort2", "sort3"}) { Parsed.Executables.push_back(Parsed.Data_Dir / Name); }
+  }
+  return Parsed;
+}
+
+auto write_csv(std::FILE* Out, const std::vector<Measurement>& Measurements) -> void
+{
+  std::println(Out, "executable,order,size,repetition,wall_s,cpu_s");
+  for (const auto& [Executable, Order, Size, Repetition, Time] : Measurements) {
+    std::println(Out, "{},{},{},{},{:.6f},{:.6f}", Executable, InputOrder_to_string_view(Order), Size, Repetition,
+                 Time.Wall_Seconds, Time.Cpu_Seconds);
+  }
+}
+}  // namespace sort_bench
+
+int main(int argc, char* argv[])
+{
+  using namespace sort_bench;
+
+  const auto Parsed = parse_options(argc, argv);
+  if (!Parsed) {
+    print_usage();
+    return 1;
+  }
+  const auto& Opts = *Parsed;
+
+  if (Opts.Cpu >= 0 && !pin_to_cpu(Opts.Cpu)) {
+    std::println(stderr, "Could not pin to CPU {}.", Opts.Cpu);
+    return 2;
+  }
+
+  std::vector<Measurement> Measurements;
+  Measurements.reserve(Opts.Executables.size() * Input_Orders.size() * Input_Sizes.size() * Opts.Repetitions);
+
+  for (const auto& Executable : Opts.Executables) {
+    const auto Exe_Name = Executable.filename().string();
+    std::println("== {} ==", Exe_Name);
+
+    // Median CPU time per (order, size), used for the fits, and the largest relative run-to-run noise of any input:
+    // a handful of repetitions per input underestimates the noise, so every order is judged against the worst one
+    std::array<std::vector<std::pair<double, double>>, Input_Orders.size()> Points;
+    double Noise = 0.0;
+
+    for (const auto Order_Idx : std::views::iota(0ul, Input_Orders.size())) {
+      const auto Order = Input_Orders[Order_Idx];
+      for (const auto Size : Input_Sizes) {
+        const auto Input_File =
+            Opts.Data_Dir / std::format("{}{}.txt", InputOrder_to_string_view(Order), Size);
+        if (!std::filesystem::exists(Input_File)) {
+          std::println(stderr, "Input file {} does not exist.", Input_File.string());
+          return 3;
+        }
+
+        for (std::size_t Warmup = 0; Warmup < Opts.Warmups; ++Warmup) { time_run(Executable, Input_File); }
+
+        std::vector<double> Cpu_Times;
+        for (std::size_t Repetition = 0; Repetition < Opts.Repetitions; ++Repetition) {
+          if (Opts.Cold) { drop_from_page_cache(Input_File); }
+          const auto Time = time_run(Executable, Input_File);
+          if (!Time) [[unlikely]] {
+            std::println(stderr, "Running {} {} failed.", Executable.string(), Input_File.string());
+            return 4;
+          }
+          Measurements.push_back({Exe_Name, Order, Size, Repetition, *Time});
+          Cpu_Times.push_back(Time->Cpu_Seconds);
+        }
+        const double Median_Time = median(Cpu_Times);
+        Points[Order_Idx].emplace_back(static_cast<double>(Size), Median_Time);
+        Noise = std::max(Noise, relative_spread(Cpu_Times, Median_Time));
+        std::println("  {:>8} {:>6}: median cpu {:.4f} s", InputOrder_to_string_view(Order), Size, Median_Time);
+      }
+    }
+
+    // Fit each input order independently
+    std::array<std::array<ModelFit, Complexities.size()>, Input_Orders.size()> Order_Fits;
+    std::optional<InputOrder> Noisy_Order;
+    for (const auto Order_Idx : std::views::iota(0ul, Input_Orders.size())) {
+      const auto Order = Input_Orders[Order_Idx];
+      if (!Noisy_Order && !rises_above_noise(Points[Order_Idx], Noise)) { Noisy_Order = Order; }
+      Order_Fits[Order_Idx] = fit_all_models(Points[Order_Idx], Noise);
+      const auto& Best = std::ranges::max(Order_Fits[Order_Idx], {}, &ModelFit::Weight);
+      std::println("  {:>8}: best fit {:<8} (weight {:5.1f}%)  t = {:.4f} s + {:.3e} * f(n)",
+                   InputOrder_to_string_view(Order), Complexity_to_string_view(Best.Model), Best.Weight * 100.0,
+                   Best.Overhead, Best.Scale);
+    }
+
+    // Score every known signature as the product of the Akaike weights of its expected per-order models
+    std::array<double, Algorithm_Signatures.size()> Scores = {};
+    for (const auto Sig_Idx : std::views::iota(0ul, Algorithm_Signatures.size())) {
+      const auto& Signature = Algorithm_Signatures[Sig_Idx];
+      Scores[Sig_Idx] = 1.0;
+      for (const auto Order_Idx : std::views::iota(0ul, Input_Orders.size())) {
+        Scores[Sig_Idx] *= Order_Fits[Order_Idx][static_cast<std::size_t>(Signature.Expected[Order_Idx])].Weight;
+      }
+    }
+    const double Total_Score = std::ranges::fold_left(Scores, 0.0, std::plus{});
+    const auto Best_Sig = static_cast<std::size_t>(std::ranges::max_element(Scores) - Scores.begin());
+    const double Best_Score = Scores[Best_Sig] / Total_Score;
+    const auto Best_Name = Algorithm_Signatures[Best_Sig].Name;
+    if (Noisy_Order) {
+      std::println("  {}: inconclusive, {} timings do not rise above the run-to-run noise ({:.1f}%); closest match {}",
+                   Exe_Name, InputOrder_to_string_view(*Noisy_Order), Noise * 100.0, Best_Name);
+    }
+    else if (Best_Score < MIN_FIT_SCORE) {
+      std::println("  {}: inconclusive, closest match {} (relative fit score {:.1f}% < {:.0f}%)", Exe_Name, Best_Name,
+                   Best_Score * 100.0, MIN_FIT_SCORE * 100.0);
+    }
+    else {
+      std::println("  {} uses: {} (relative fit score {:.1f}%, not a probability)", Exe_Name, Best_Name,
+                   Best_Score * 100.0);
+    }
+  }
+
+  // Raw timings
+  if (Opts.Csv_File) {
+    std::FILE* Csv_Out = std::fopen(Opts.Csv_File->c_str(), "w");
+    if (Csv_Out == nullptr) {
+      std::println(stderr, "Could not create {}.", Opts.Csv_File->string());
+      return 5;
+    }
+    write_csv(Csv_Out, Measurements);
+    std::fclose(Csv_Out);
+  }
+  else {
+    std::println();
+    write_csv(stdout, Measurements);
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+#ifndef ARENA_HXX
+#define ARENA_HXX
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <span>
+#include <type_traits>
+
+////
+/// Single-allocation bump arena
+//
+// The BMP header, the pixels and any filter scratch space are carved out of one aligned block that is sized up
+// front, so pixel and scratch memory come from one allocation. Every allocation is aligned to ALIGNMENT.
+// Scratch space is handed back with ArenaScope, which rewinds the arena when it goes out of scope.
+//
+struct Arena_t_Deleter
+{
+  static constexpr std::size_t ALIGNMENT = 64;  // one cache line, wide enough for AVX-512
+
+  auto operator()(std::byte* Ptr) const noexcept -> void
+  {
+    ::operator delete[](Ptr, std::align_val_t{ALIGNMENT});
+  }
+};
+
+using Arena_t_Ptr = std::unique_ptr<std::byte[], Arena_t_Deleter>;
+
+class Arena_t
+{
+public:
+  static constexpr std::size_t ALIGNMENT = Arena_t_Deleter::ALIGNMENT;
+
+private:
+  Arena_t_Ptr Block_;
+  std::size_t Capacity_;
+  std::size_t Used_ = 0;
+
+  Arena_t(Arena_t_Ptr Block, const std::size_t Capacity) noexcept : Block_(std::move(Block)), Capacity_(Capacity) {}
+
+public:
+  // Bytes to reserve for Count objects of T, including worst-case alignment padding; saturates on overflow
+  template <typename T>
+  [[nodiscard]] static constexpr auto bytes_for(const std::size_t Count) noexcept
+  {
+    return std::add_sat(std::mul_sat(Count, sizeof(T)), ALIGNMENT);
+  }
+
+  // Reserve Capacity bytes; std::nullopt if the memory is not available
+  [[nodiscard]] static auto create(const std::size_t Capacity) noexcept -> std::optional<Arena_t>
+  {
+    auto* Block = static_cast<std::byte*>(::operator new[](Capacity, std::align_val_t{ALIGNMENT}, std::nothrow));
+    if (Block == nullptr) { return std::nullopt; }
+    return Arena_t(Arena_t_Ptr(Block), Capacity);
+  }
+
+  // Uninitialised storage for Count objects of T
+  template <typename T>
+  [[nodiscard]] auto allocate(const std::size_t Count) noexcept -> std::span<T>
+  {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "Arena_t only holds trivial types");
+    const auto Offset = (Used_ + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    const auto Bytes = std::mul_sat(Count, sizeof(T));
+    if (Offset > Capacity_ || Bytes > Capacity_ - Offset) [[unlikely]] {
+      // Sizes are computed before the arena is created, so running out is a bug
+      std::println("Arena exhausted");
+      std::abort();
+    }
+    Used_ = Offset + Bytes;
+    return std::span<T>(std::bit_cast<T*>(Block_.get() + Offset), Count);
+  }
+
+  [[nodiscard]] auto used() const noexcept
+  {
+    return Used_;
+  }
+  [[nodiscard]] auto capacity() const noexcept
+  {
+    return Capacity_;
+  }
+
+  // Rewind to an earlier used() value, releasing everything allocated since
+  auto release(const std::size_t Mark) noexcept -> void
+  {
+    Used_ = Mark;
+  }
+};
+
+////
+/// Scratch allocations made while an ArenaScope is alive are released when it is destroyed
+//
+class ArenaScope
+{
+private:
+  Arena_t& Arena_;
+  std::size_t Mark_;
+
+public:
+  explicit ArenaScope(Arena_t& Arena) noexcept : Arena_(Arena), Mark_(Arena.used()) {}
+  ArenaScope(const ArenaScope&) = delete;
+  auto operator=(const ArenaScope&) -> ArenaScope& = delete;
+  ~ArenaScope()
+  {
+    Arena_.release(Mark_);
+  }
+};
+#endif  // ARENA_HXX
@@ -0,0 +1,222 @@
+#ifndef BMP_IO_HXX
+#define BMP_IO_HXX
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <optional>
+#include <span>
+
+#include "arena.hxx"
+#include "bmp.hxx"
+
+////
+/// Reading and writing BMP files
+//
+// Accepts uncompressed 24-bit and 32-bit BMPs with a BITMAPINFOHEADER or one of its larger successors (V4, V5),
+// stored bottom-up (positive biHeight) or top-down (negative biHeight). A 32-bit image must be BI_RGB or
+// BI_BITFIELDS with the standard BGRA masks.
+//
+// In memory the pixels are always RGBTRIPLEs, top row first, whatever the order in the file. The alpha channel of
+// a 32-bit image is kept aside and written back untouched, and everything in front of the pixel data (headers,
+// masks, palette) is written back byte for byte, so the output has the format of the input.
+//
+// Sizes are computed in std::size_t with saturating arithmetic, and a header that claims more pixel data than the
+// file holds is rejected before anything is allocated.
+//
+constexpr WORD BMP_SIGNATURE = 0x4d42;  // "BM"
+constexpr DWORD BI_RGB = 0;
+constexpr DWORD BI_BITFIELDS = 3;
+
+// Red, green and blue masks of a BI_BITFIELDS image with BGRA byte order
+inline constexpr std::array<DWORD, 3> BGRA_Bit_Masks = {0x00ff0000, 0x0000ff00, 0x000000ff};
+
+////
+/// Geometry of a BMP file, from its headers
+//
+struct BmpLayout
+{
+  std::size_t Header_Bytes;  // bfOffBits: everything in front of the pixel data
+  std::size_t Height;        // Image height
+  std::size_t Width;         // Image width in pixels
+  std::size_t Row_Bytes;     // One scanline in the file, padding included
+  std::uint16_t Bit_Count;   // 24 or 32
+  bool Top_Down;             // First scanline in the file is the top row
+
+  [[nodiscard]] constexpr auto pixel_bytes() const noexcept
+  {
+    return Bit_Count / 8u;
+  }
+};
+
+////
+/// A BMP file loaded into an arena
+//
+struct BmpImage
+{
+  BmpLayout Layout;
+  std::span<std::byte> Header;     // Header_Bytes bytes, written back as they were read
+  std::span<RGBTRIPLE> Pixels;     // Height x Width, top row first
+  std::span<std::uint8_t> Alpha;   // Height x Width for 32-bit images, empty otherwise
+  std::span<std::byte> Scanline;   // One file scanline of I/O buffer
+};
+
+////
+/// Read and check the headers of In_Ptr; std::nullopt if the format is not supported or the file is too short
+//
+inline auto read_bmp_layout(FILE* In_Ptr) -> std::optional<BmpLayout>
+{
+  if (fseek(In_Ptr, 0, SEEK_END) != 0) { return std::nullopt; }
+  const long File_Bytes = ftell(In_Ptr);
+  if (File_Bytes < 0 || fseek(In_Ptr, 0, SEEK_SET) != 0) { return std::nullopt; }
+
+  BITMAPFILEHEADER Bitmap_File_Header = {};
+  BITMAPINFOHEADER Bitmap_Info_Header = {};
+  if (fread(&Bitmap_File_Header, sizeof(BITMAPFILEHEADER), 1, In_Ptr) != 1 ||
+      fread(&Bitmap_Info_Header, sizeof(BITMAPINFOHEADER), 1, In_Ptr) != 1) {
+    return std::nullopt;
+  }
+
+  const std::size_t Header_Bytes = Bitmap_File_Header.bfOffBits;
+  if (Bitmap_File_Header.bfType != BMP_SIGNATURE || Bitmap_Info_Header.biSize < sizeof(BITMAPINFOHEADER) ||
+      Header_Bytes < sizeof(BITMAPFILEHEADER) + std::size_t{Bitmap_Info_Header.biSize} ||
+      Bitmap_Info_Header.biPlanes != 1 || Bitmap_Info_Header.biWidth <= 0 || Bitmap_Info_Header.biHeight == 0) {
+    return std::nullopt;
+  }
+
+  // Pixel format: 24-bit BI_RGB, 32-bit BI_RGB or 32-bit BGRA BI_BITFIELDS
+  const auto Bit_Count = Bitmap_Info_Header.biBitCount;
+  const auto Compression = Bitmap_Info_Header.biCompression;
+  if (Bit_Count == 32 && Compression == BI_BITFIELDS) {
+    // The masks follow a plain BITMAPINFOHEADER and are the next fields of the larger headers
+    std::array<DWORD, 3> Bit_Masks = {};
+    if (Header_Bytes < sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER) + sizeof(Bit_Masks) ||
+        fread(Bit_Masks.data(), sizeof(Bit_Masks), 1, In_Ptr) != 1 || Bit_Masks != BGRA_Bit_Masks) {
+      return std::nullopt;
+    }
+  }
+  else if ((Bit_Count != 24 && Bit_Count != 32) || Compression != BI_RGB) {
+    return std::nullopt;
+  }
+
+  // biHeight is widened before the sign is dropped, so INT32_MIN does not overflow
+  const auto Signed_Height = static_cast<std::int64_t>(Bitmap_Info_Header.biHeight);
+  BmpLayout Layout = {
+      .Header_Bytes = Header_Bytes,
+      .Height = static_cast<std::size_t>(Signed_Height < 0 ? -Signed_Height : Signed_Height),
+      .Width = static_cast<std::size_t>(Bitmap_Info_Header.biWidth),
+      .Row_Bytes = 0,
+      .Bit_Count = Bit_Count,
+      .Top_Down = Signed_Height < 0,
+  };
+
+  // Scanlines are padded to a multiple of 4 bytes
+  Layout.Row_Bytes = std::mul_sat(Layout.Width, std::size_t{Layout.pixel_bytes()});
+  Layout.Row_Bytes = std::add_sat(Layout.Row_Bytes, std::size_t{3}) / 4 * 4;
+
+  // The pixel data has to be in the file
+  const auto Data_Bytes = std::mul_sat(Layout.Row_Bytes, Layout.Height);
+  if (std::add_sat(Header_Bytes, Data_Bytes) > static_cast<std::size_t>(File_Bytes)) { return std::nullopt; }
+  return Layout;
+}
+
+////
+/// Arena space read_bmp() takes for Layout
+//
+constexpr auto bmp_arena_bytes(const BmpLayout& Layout) noexcept
+{
+  const auto Pixel_Count = std::mul_sat(Layout.Height, Layout.Width);
+  const auto Alpha_Count = Layout.Bit_Count == 32 ? Pixel_Count : 0;
+  return std::add_sat(
+      std::add_sat(Arena_t::bytes_for<std::byte>(Layout.Header_Bytes), Arena_t::bytes_for<RGBTRIPLE>(Pixel_Count)),
+      std::add_sat(Arena_t::bytes_for<std::uint8_t>(Alpha_Count), Arena_t::bytes_for<std::byte>(Layout.Row_Bytes)));
+}
+
+////
+/// Load the header and the pixels of In_Ptr into Arena; std::nullopt on a read error
+//
+inline auto read_bmp(FILE* In_Ptr, const BmpLayout& Layout, Arena_t& Arena) -> std::optional<BmpImage>
+{
+  const auto Pixel_Count = Layout.Height * Layout.Width;
+  BmpImage Image = {
+      .Layout = Layout,
+      .Header = Arena.allocate<std::byte>(Layout.Header_Bytes),
+      .Pixels = Arena.allocate<RGBTRIPLE>(Pixel_Count),
+      .Alpha = Arena.allocate<std::uint8_t>(Layout.Bit_Count == 32 ? Pixel_Count : 0),
+      .Scanline = Arena.allocate<std::byte>(Layout.Row_Bytes),
+  };
+
+  if (fseek(In_Ptr, 0, SEEK_SET) != 0 ||
+      fread(Image.Header.data(), 1, Image.Header.size(), In_Ptr) != Image.Header.size()) {
+    return std::nullopt;
+  }
+
+  const std::size_t Width = Layout.Width;
+  for (std::size_t File_Row = 0; File_Row < Layout.Height; ++File_Row) {
+    const auto Row_Pos = Layout.Top_Down ? File_Row : Layout.Height - 1 - File_Row;
+    auto* Row = Image.Pixels.data() + Row_Pos * Width;
+
+    if (Layout.Bit_Count == 24) {
+      // Straight into the pixel row; only the padding goes through the scanline buffer
+      const auto Padding = Layout.Row_Bytes - Width * sizeof(RGBTRIPLE);
+      if (fread(Row, sizeof(RGBTRIPLE), Width, In_Ptr) != Width ||
+          fread(Image.Scanline.data(), 1, Padding, In_Ptr) != Padding) {
+        return std::nullopt;
+      }
+      continue;
+    }
+
+    // BGRA: split off the alpha channel
+    if (fread(Image.Scanline.data(), 1, Layout.Row_Bytes, In_Ptr) != Layout.Row_Bytes) { return std::nullopt; }
+    auto* Alpha = Image.Alpha.data() + Row_Pos * Width;
+    const auto* Bytes = Image.Scanline.data();
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      Row[Col_Pos] = RGBTRIPLE{std::to_integer<std::uint8_t>(Bytes[4 * Col_Pos]),
+                               std::to_integer<std::uint8_t>(Bytes[4 * Col_Pos + 1]),
+                               std::to_integer<std::uint8_t>(Bytes[4 * Col_Pos + 2])};
+      Alpha[Col_Pos] = std::to_integer<std::uint8_t>(Bytes[4 * Col_Pos + 3]);
+    }
+  }
+  return Image;
+}
+
+////
+/// Write Image to Out_Ptr in the format it was read in; false on a write error
+//
+inline auto write_bmp(FILE* Out_Ptr, const BmpImage& Image) -> bool
+{
+  const auto& Layout = Image.Layout;
+  if (fwrite(Image.Header.data(), 1, Image.Header.size(), Out_Ptr) != Image.Header.size()) { return false; }
+
+  const std::size_t Width = Layout.Width;
+  std::ranges::fill(Image.Scanline, std::byte{0});
+  for (std::size_t File_Row = 0; File_Row < Layout.Height; ++File_Row) {
+    const auto Row_Pos = Layout.Top_Down ? File_Row : Layout.Height - 1 - File_Row;
+    const auto* Row = Image.Pixels.data() + Row_Pos * Width;
+
+    if (Layout.Bit_Count == 24) {
+      // The scanline buffer is all zeros, so it doubles as the padding
+      const auto Padding = Layout.Row_Bytes - Width * sizeof(RGBTRIPLE);
+      if (fwrite(Row, sizeof(RGBTRIPLE), Width, Out_Ptr) != Width ||
+          fwrite(Image.Scanline.data(), 1, Padding, Out_Ptr) != Padding) {
+        return false;
+      }
+      continue;
+    }
+
+    // BGRA: put the alpha channel back
+    const auto* Alpha = Image.Alpha.data() + Row_Pos * Width;
+    auto* Bytes = Image.Scanline.data();
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      Bytes[4 * Col_Pos] = std::byte{Row[Col_Pos].rgbtBlue};
+      Bytes[4 * Col_Pos + 1] = std::byte{Row[Col_Pos].rgbtGreen};
+      Bytes[4 * Col_Pos + 2] = std::byte{Row[Col_Pos].rgbtRed};
+      Bytes[4 * Col_Pos + 3] = std::byte{Alpha[Col_Pos]};
+    }
+    if (fwrite(Bytes, 1, Layout.Row_Bytes, Out_Ptr) != Layout.Row_Bytes) { return false; }
+  }
+  return true;
+}
+#endif  // BMP_IO_HXX
@@ -0,0 +1,254 @@
+#ifndef CONVOLUTION_HXX
+#define CONVOLUTION_HXX
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mdspan>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#include "arena.hxx"
+#include "bmp.hxx"
+
+////
+/// Generic convolution engine
+//
+// A kernel is a compile-time value (size and coefficients are template arguments), so for every kernel the
+// engine generates
+//   - an interior path with the tap loop fully unrolled and zero taps removed, used wherever the whole kernel
+//     fits inside the image, and
+//   - a border path with bounds handling, used for the outer RADIUS rows and columns only.
+// Sums are accumulated in int32 when every coefficient is a whole number and in float otherwise.
+//
+// A filter is a kernel (or several, e.g. Sobel GX and GY) plus an emit function that turns the per-channel sums
+// into the output byte.
+//
+
+// What a kernel tap outside the image reads
+enum class BorderMode : std::uint8_t
+{
+  SKIP,  // the tap is dropped, and its coefficient does not count towards the weight
+  CLAMP  // the tap reads the nearest edge pixel
+};
+
+template <std::size_t SIZE>
+struct ConvolutionKernel
+{
+  static_assert(SIZE % 2 == 1, "Convolution kernels must have an odd size");
+  static constexpr std::size_t WIDTH = SIZE;
+  static constexpr std::size_t RADIUS = SIZE / 2;
+
+  std::array<float, SIZE * SIZE> Coefficients;
+  BorderMode Border = BorderMode::SKIP;
+
+  [[nodiscard]] constexpr auto operator[](const std::size_t Row, const std::size_t Col) const noexcept
+  {
+    return Coefficients[Row * SIZE + Col];
+  }
+
+  // Every coefficient is a whole number, so the sums are exact in integer arithmetic
+  [[nodiscard]] constexpr auto is_integral() const noexcept
+  {
+    return std::ranges::all_of(Coefficients, [](const float Coefficient) {
+      return Coefficient == static_cast<float>(static_cast<std::int32_t>(Coefficient));
+    });
+  }
+
+  // Sum of all coefficients
+  [[nodiscard]] constexpr auto weight() const noexcept
+  {
+    float Weight = 0.0f;
+    for (const auto Coefficient : Coefficients) { Weight += Coefficient; }
+    return Weight;
+  }
+};
+
+// Accumulator type chosen from the coefficients at compile time
+template <ConvolutionKernel Kernel>
+using Accumulator_t = std::conditional_t<Kernel.is_integral(), std::int32_t, float>;
+
+// Sum of one channel under one kernel, together with the weight of the taps that contributed
+template <typename Acc>
+struct ChannelSum
+{
+  Acc Value;
+  Acc Weight;
+};
+
+////
+/// Channel access for packed (RGBTRIPLE) and planar (uint8_t) pixels
+//
+constexpr auto pixel_channels(const RGBTRIPLE& Pixel) noexcept
+{
+  return std::array{Pixel.rgbtBlue, Pixel.rgbtGreen, Pixel.rgbtRed};
+}
+constexpr auto pixel_channels(const std::uint8_t Value) noexcept
+{
+  return std::array{Value};
+}
+
+template <typename Pixel>
+constexpr auto channels_to_pixel(const auto& Channels) noexcept -> Pixel
+{
+  if constexpr (std::is_same_v<Pixel, RGBTRIPLE>) {
+    return RGBTRIPLE{Channels[0], Channels[1], Channels[2]};
+  }
+  else {
+    return Channels[0];
+  }
+}
+
+namespace convolution_detail
+{
+template <typename Acc, std::size_t CHANNELS>
+struct KernelSums
+{
+  std::array<Acc, CHANNELS> Values{};
+  Acc Weight{};
+};
+
+template <typename Pixel>
+inline constexpr std::size_t CHANNELS_OF = pixel_channels(Pixel{}).size();
+
+// Add one tap; taps with a zero coefficient generate no code
+template <ConvolutionKernel Kernel, std::size_t TAP>
+constexpr auto accumulate_tap(auto& Sums, const auto& Pixel) noexcept -> void
+{
+  constexpr auto Coefficient = static_cast<Accumulator_t<Kernel>>(Kernel.Coefficients[TAP]);
+  if constexpr (Coefficient != 0) {
+    const auto Channels = pixel_channels(Pixel);
+    for (std::size_t C = 0; C < Channels.size(); ++C) { Sums.Values[C] += Coefficient * Channels[C]; }
+  }
+}
+
+////
+/// Interior path: the whole kernel lies inside the image, the tap loop is unrolled at compile time
+//
+template <ConvolutionKernel Kernel>
+constexpr auto apply_interior(const auto& Ref_Span, const std::size_t Row_Pos, const std::size_t Col_Pos) noexcept
+{
+  using Acc = Accumulator_t<Kernel>;
+  using Pixel = std::remove_cvref_t<decltype(Ref_Span[0, 0])>;
+  KernelSums<Acc, CHANNELS_OF<Pixel>> Sums;
+
+  [&]<std::size_t... TAPS>(std::index_sequence<TAPS...>) {
+    (accumulate_tap<Kernel, TAPS>(Sums, Ref_Span[Row_Pos + TAPS / Kernel.WIDTH - Kernel.RADIUS,
+                                                 Col_Pos + TAPS % Kernel.WIDTH - Kernel.RADIUS]),
+     ...);
+  }(std::make_index_sequence<Kernel.Coefficients.size()>{});
+
+  Sums.Weight = static_cast<Acc>(Kernel.weight());
+  return Sums;
+}
+
+////
+/// Border path: some taps fall outside the image and are skipped or clamped according to Kernel.Border
+//
+template <ConvolutionKernel Kernel>
+constexpr auto apply_border(const auto& Ref_Span, const std::size_t Row_Pos, const std::size_t Col_Pos) noexcept
+{
+  using Acc = Accumulator_t<Kernel>;
+  using Pixel = std::remove_cvref_t<decltype(Ref_Span[0, 0])>;
+  KernelSums<Acc, CHANNELS_OF<Pixel>> Sums;
+
+  const auto Height = static_cast<std::ptrdiff_t>(Ref_Span.extent(0));
+  const auto Width = static_cast<std::ptrdiff_t>(Ref_Span.extent(1));
+  constexpr auto RADIUS = static_cast<std::ptrdiff_t>(Kernel.RADIUS);
+
+  for (std::size_t Tap_Row = 0; Tap_Row < Kernel.WIDTH; ++Tap_Row) {
+    for (std::size_t Tap_Col = 0; Tap_Col < Kernel.WIDTH; ++Tap_Col) {
+      const auto Coefficient = static_cast<Acc>(Kernel[Tap_Row, Tap_Col]);
+      if (Coefficient == 0) { continue; }
+
+      auto Row = static_cast<std::ptrdiff_t>(Row_Pos + Tap_Row) - RADIUS;
+      auto Col = static_cast<std::ptrdiff_t>(Col_Pos + Tap_Col) - RADIUS;
+      if constexpr (Kernel.Border == BorderMode::CLAMP) {
+        Row = std::clamp(Row, std::ptrdiff_t{0}, Height - 1);
+        Col = std::clamp(Col, std::ptrdiff_t{0}, Width - 1);
+      }
+      else if (Row < 0 || Row >= Height || Col < 0 || Col >= Width) {
+        continue;
+      }
+
+      const auto Channels = pixel_channels(Ref_Span[static_cast<std::size_t>(Row), static_cast<std::size_t>(Col)]);
+      for (std::size_t C = 0; C < Channels.size(); ++C) { Sums.Values[C] += Coefficient * Channels[C]; }
+      Sums.Weight += Coefficient;
+    }
+  }
+  return Sums;
+}
+}  // namespace convolution_detail
+
+////
+/// Convolve Image_Span with one or more kernels
+//
+// Emit is called once per channel with a ChannelSum per kernel and returns the output byte. Works on packed
+// RGBTRIPLE images and on single uint8_t planes. The reference copy lives in Scratch and is released on return;
+// convolve_scratch_bytes() is how much it needs.
+//
+template <ConvolutionKernel... Kernels>
+auto convolve(auto& Image_Span, Arena_t& Scratch, auto emit) -> void
+{
+  static_assert(sizeof...(Kernels) > 0, "convolve needs at least one kernel");
+  using namespace convolution_detail;
+  using Pixel = std::remove_cvref_t<decltype(Image_Span[0, 0])>;
+  constexpr auto CHANNELS = CHANNELS_OF<Pixel>;
+  constexpr auto RADIUS = std::max({Kernels.RADIUS...});
+
+  const std::size_t Height = Image_Span.extent(0);
+  const std::size_t Width = Image_Span.extent(1);
+
+  ////
+  /// Reference copy: every output pixel reads the unfiltered image
+  //
+  const ArenaScope Scope(Scratch);
+  auto Image_Ref = Scratch.allocate<Pixel>(Height * Width);
+  auto Ref_Span = std::mdspan(Image_Ref.data(), Height, Width);
+  for (std::size_t Row_Pos = 0; Row_Pos < Height; ++Row_Pos) {
+    std::copy_n(&Image_Span[Row_Pos, 0], Width, &Ref_Span[Row_Pos, 0]);
+  }
+
+  auto emit_pixel = [&](const auto&... Sums) {
+    std::array<std::uint8_t, CHANNELS> Channels = {};
+    for (std::size_t C = 0; C < CHANNELS; ++C) {
+      Channels[C] = emit(ChannelSum{Sums.Values[C], Sums.Weight}...);
+    }
+    return channels_to_pixel<Pixel>(Channels);
+  };
+  auto border_pixel = [&](const std::size_t Row_Pos, const std::size_t Col_Pos) {
+    Image_Span[Row_Pos, Col_Pos] = emit_pixel(apply_border<Kernels>(Ref_Span, Row_Pos, Col_Pos)...);
+  };
+  auto interior_pixel = [&](const std::size_t Row_Pos, const std::size_t Col_Pos) {
+    Image_Span[Row_Pos, Col_Pos] = emit_pixel(apply_interior<Kernels>(Ref_Span, Row_Pos, Col_Pos)...);
+  };
+
+  for (std::size_t Row_Pos = 0; Row_Pos < Height; ++Row_Pos) {
+    if (Row_Pos < RADIUS || Row_Pos + RADIUS >= Height) [[unlikely]] {
+      // Top and bottom border rows
+      for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) { border_pixel(Row_Pos, Col_Pos); }
+      continue;
+    }
+    std::size_t Col_Pos = 0;
+    for (; Col_Pos < std::min(RADIUS, Width); ++Col_Pos) { border_pixel(Row_Pos, Col_Pos); }
+    for (; Col_Pos + RADIUS < Width; ++Col_Pos) { interior_pixel(Row_Pos, Col_Pos); }
+    for (; Col_Pos < Width; ++Col_Pos) { border_pixel(Row_Pos, Col_Pos); }
+  }
+}
+
+// Arena space convolve() takes for a Height x Width image of Pixel
+template <typename Pixel>
+constexpr auto convolve_scratch_bytes(const std::size_t Height, const std::size_t Width) noexcept
+{
+  return Arena_t::bytes_for<Pixel>(std::mul_sat(Height, Width));
+}
+
+////
+/// Emit function: weighted mean of the taps, rounded and clamped to a byte
+//
+inline constexpr auto weighted_mean = [](const auto& Sum) -> std::uint8_t {
+  return static_cast<std::uint8_t>(std::clamp(std::round(Sum.Value / static_cast<float>(Sum.Weight)), 0.0f, 255.0f));
+};
+#endif  // CONVOLUTION_HXX
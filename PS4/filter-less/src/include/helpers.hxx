@@ -5,12 +5,15 @@
 #include <cassert>
 #include <cmath>
 #include <mdspan>
-#include <memory>
 #include <numeric>
 #include <print>
 #include <ranges>
 
+#include "arena.hxx"
 #include "bmp.hxx"
+#include "convolution.hxx"
+#include "orientation.hxx"
+#include "planar.hxx"
 
 template <typename T>
 struct IsMdspan : std::false_type
@@ -73,165 +76,6 @@ inline auto float_to_int = [](const float Value) {
   return static_cast<std::uint8_t>(Value);
 };
 
-// enum Class and FSM to track action to take
-//
-// enum class
-enum class PositionType : std::uint8_t
-{
-  UL,
-  UR,
-  LL,
-  LR,
-  TR,
-  BR,
-  LE,
-  RE,
-  GC
-};
-
-////
-/// Finite State Machine (FSM)
-//
-// manages pixel-position-based state transition in an image.
-//
-class PixelPositionFSM
-{
-private:
-  std::size_t Height_; // Image height
-  std::size_t Width_; // Image width
-  std::size_t Current_Position_; // Current position in 1D space
-  PositionType Current_State_; // Current state of the pixel position
-
-public:
-  // Constructor initializes the dimensions and starts at state UL
-  PixelPositionFSM(const std::size_t Height, const std::size_t Width)
-    : Height_(Height), Width_(Width), Current_Position_(0ul), Current_State_(PositionType::UL)
-  {
-  }
-
-  // Getter for the current state
-  [[nodiscard]] auto operator()() const noexcept
-  {
-    return Current_State_;
-  }
-
-  // Increment operator to transition between states
-  auto operator++() noexcept -> PixelPositionFSM&
-  {
-    const auto New_Position = Current_Position_ + 1;
-    const auto Current_Row = Current_Position_ / Width_;
-    [[maybe_unused]] const auto Current_Row_Begin = Current_Row * Width_;
-    const auto Current_Row_End = (Current_Row + 1) * Width_ - 1;
-
-    // Helper lambda to perform assertions
-    auto assertState = [&](const PositionType state) {
-      switch (state) {
-        case PositionType::UL:
-          assert(Current_Position_ == Current_Row_Begin);
-          assert(Current_Row == 0ul);
-          break;
-        case PositionType::TR:
-          assert(Current_Position_ > Current_Row_Begin);
-          assert(Current_Position_ < Current_Row_End);
-          assert(Current_Row == 0ul);
-          break;
-        case PositionType::UR:
-          assert(Current_Position_ == Current_Row_End);
-          assert(Current_Row == 0ul);
-          break;
-        case PositionType::LE:
-          assert(Current_Position_ == Current_Row_Begin);
-          assert(Current_Row > 0ul);
-          assert(Current_Row < Height_ - 1ul);
-          break;
-        case PositionType::GC:
-          assert(Current_Position_ > Current_Row_Begin);
-          assert(Current_Position_ < Current_Row_End);
-          assert(Current_Row > 0ul);
-          assert(Current_Row < Height_ - 1ul);
-          break;
-        case PositionType::RE:
-          assert(Current_Position_ == Current_Row_End);
-          assert(Current_Row < Height_ - 1ul);
-          break;
-        case PositionType::LL:
-          assert(Current_Position_ == Current_Row_Begin);
-          assert(Current_Row == Height_ - 1ul);
-          break;
-        case PositionType::BR:
-          assert(Current_Position_ > Current_Row_Begin);
-          assert(Current_Position_ < Current_Row_End);
-          assert(Current_Row == Height_ - 1ul);
-          break;
-        case PositionType::LR: // fallthrough
-        default:
-          break;
-      }
-    };
-
-    // Perform assertions for the current state
-    assertState(Current_State_);
-
-    // Handle transitions using a switch statement with adornments
-    switch (Current_State_) {
-      case PositionType::UL:
-        [[unlikely]] // UL → TR happens only once at the very beginning
-            Current_State_ = PositionType::TR;
-        break;
-      case PositionType::TR:
-        [[unlikely]] // TR → UR happens only once at the end of the first row
-        if (New_Position == Current_Row_End) {
-          Current_State_ = PositionType::UR;
-        }
-        break;
-      case PositionType::UR:
-        [[unlikely]] // UR → LE happens only once after the first row
-            Current_State_ = PositionType::LE;
-        break;
-      case PositionType::LE:
-        [[likely]] // LE → GC happens frequently for most left-edge pixels
-            Current_State_ = PositionType::GC;
-        break;
-      case PositionType::GC:
-        [[likely]] // GC → RE happens frequently for most general-case pixels
-        if (New_Position == Current_Row_End) {
-          Current_State_ = PositionType::RE;
-        }
-        break;
-      case PositionType::RE:
-        if (Current_Row == Height_ - 2ul) {
-          [[unlikely]] // RE → LL happens only once for the second-to-last row
-              Current_State_ = PositionType::LL;
-        }
-        else {
-          [[likely]] // RE → LE happens frequently for most right-edge pixels
-              Current_State_ = PositionType::LE;
-        }
-        break;
-      case PositionType::LL:
-        [[unlikely]] // LL → BR happens only once at the beginning of the last row
-            Current_State_ = PositionType::BR;
-        break;
-      case PositionType::BR:
-        [[unlikely]] // BR → LR happens only once at the end of the last row
-        if (New_Position == Current_Row_End) {
-          Current_State_ = PositionType::LR;
-        }
-        break;
-      case PositionType::LR:
-        [[unlikely]]
-            return *this;
-      default:
-        [[unlikely]] // unexpected state
-            std::println("Unexpected state in PixelPositionFSM");
-        std::abort();
-        //  throw std::runtime_error("Unexpected state in PixelPositionFSM");
-    }
-    ++Current_Position_; // Increment the position
-    return *this;
-  }
-};
-
 ////
 /// Convert Image to greyscale
 //
@@ -261,8 +105,8 @@ auto grey_scale(auto& Image_Span) -> void
 // Retained here for educational value — it demonstrates reversible bitwise logic
 // and offers insight into data movement without auxiliary variables.
 //
-// Note: The main reflect() function uses std::swap due to better optimizer support
-// and slightly faster performance in benchmarking.
+// Note: The remainder path of reverse_scanline() uses std::swap (through std::reverse) due to better
+// optimizer support and slightly faster performance in benchmarking.
 //
 inline auto xor_swap_RGBTRIPLE = [](RGBTRIPLE& lhs, RGBTRIPLE& rhs) {
   lhs.rgbtBlue ^= rhs.rgbtBlue;
@@ -281,29 +125,78 @@ inline auto xor_swap_RGBTRIPLE = [](RGBTRIPLE& lhs, RGBTRIPLE& rhs) {
 ////
 /// Reflect image horizontally
 //
-auto reflect(auto& Image_Span)
+// Every row is reversed on its own, so batches of rows run in parallel.
+//
+auto reflect(auto& Image_Span, const RowBatching Batching = {}) -> void
 {
-  for (auto [Row_Pos, Col_Pos] : index_mdspan(Image_Span)) {
-    if (const std::size_t Width = Image_Span.extent(1); Col_Pos < Width / 2)
-    // we need to swap if not reached midway point
-    {
-      // xor_swap_RGBTRIPLE(Image_Span[Row_Pos, Col_Pos], Image_Span[Row_Pos, (Width - 1) - Col_Pos]);
-      std::swap(Image_Span[Row_Pos, Col_Pos], Image_Span[Row_Pos, Width - 1 - Col_Pos]);
-    }
-  }
+  const std::size_t Width = Image_Span.extent(1);
+  for_each_row_batch(
+      Image_Span.extent(0), Width * sizeof(Image_Span[0, 0]),
+      [&](const std::size_t Row_Begin, const std::size_t Row_End) {
+        for (auto Row_Pos = Row_Begin; Row_Pos < Row_End; ++Row_Pos) {
+          reverse_scanline(&Image_Span[Row_Pos, 0], Width);
+        }
+      },
+      Batching);
+}
+
+////
+/// Flip image vertically
+//
+// Rows trade places as whole blocks of bytes; the pixels inside a row are not touched.
+//
+auto flip_vertical(auto& Image_Span, const RowBatching Batching = {}) -> void
+{
+  const std::size_t Height = Image_Span.extent(0);
+  const std::size_t Row_Bytes = Image_Span.extent(1) * sizeof(Image_Span[0, 0]);
+  for_each_row_batch(
+      Height / 2, 2 * Row_Bytes,
+      [&](const std::size_t Row_Begin, const std::size_t Row_End) {
+        for (auto Row_Pos = Row_Begin; Row_Pos < Row_End; ++Row_Pos) {
+          swap_scanlines(&Image_Span[Row_Pos, 0], &Image_Span[Height - 1 - Row_Pos, 0], Row_Bytes);
+        }
+      },
+      Batching);
+}
+
+////
+/// Rotate image by 180°
+//
+// A vertical flip followed by reversing both swapped rows while they are still in cache.
+//
+auto rotate_180(auto& Image_Span, const RowBatching Batching = {}) -> void
+{
+  const std::size_t Height = Image_Span.extent(0);
+  const std::size_t Width = Image_Span.extent(1);
+  const std::size_t Row_Bytes = Width * sizeof(Image_Span[0, 0]);
+  for_each_row_batch(
+      Height / 2, 2 * Row_Bytes,
+      [&](const std::size_t Row_Begin, const std::size_t Row_End) {
+        for (auto Row_Pos = Row_Begin; Row_Pos < Row_End; ++Row_Pos) {
+          auto* Top_Row = &Image_Span[Row_Pos, 0];
+          auto* Bottom_Row = &Image_Span[Height - 1 - Row_Pos, 0];
+          swap_scanlines(Top_Row, Bottom_Row, Row_Bytes);
+          reverse_scanline(Top_Row, Width);
+          reverse_scanline(Bottom_Row, Width);
+        }
+      },
+      Batching);
+  // The middle row of an odd-height image only needs reversing
+  if (Height % 2 != 0) { reverse_scanline(&Image_Span[Height / 2, 0], Width); }
 }
 
 ////
 /// Convert image to sepia
 //
+// Precompute sepia coefficients
+// 0-2 blue to sepia
+// 3-5 green to sepia
+// 6-8 red to sepia
+inline constexpr std::array Sepia_Coefficients = {0.131f, 0.534f, 0.272f, 0.168f, 0.686f,
+                                                  0.349f, 0.189f, 0.769f, 0.393f};
+
 auto sepia(auto& Image_Span)
 {
-  // Precompute sepia coefficients
-  // 0-2 blue to sepia
-  // 3-5 green to sepia
-  // 6-8 red to sepia
-  static constexpr std::array Sepia_Coefficients = {0.131f, 0.534f, 0.272f, 0.168f, 0.686f,
-                                                    0.349f, 0.189f, 0.769f, 0.393f};
   // using std::mdspan to map std::array into a 2d array,
   // Each row corresponds to one output channel (in BGR order)
   // Each row contains coefficients applied to input channels (B, G, R), in that order
@@ -325,321 +218,330 @@ auto sepia(auto& Image_Span)
   }
 }
 
+////
+/// Convolution kernels
+//
+// Box blur averages the pixel and whichever neighbours lie inside the image.
+inline constexpr ConvolutionKernel<3> Box_Blur_Kernel = {{1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+                                                         BorderMode::SKIP};
+// Sobel GX and GY treat everything outside the image as black.
+inline constexpr ConvolutionKernel<3> Sobel_GX_Kernel = {{-1.0f, 0.0f, +1.0f, -2.0f, 0.0f, +2.0f, -1.0f, 0.0f, +1.0f},
+                                                         BorderMode::SKIP};
+inline constexpr ConvolutionKernel<3> Sobel_GY_Kernel = {{-1.0f, -2.0f, -1.0f, 0.0f, 0.0f, 0.0f, +1.0f, +2.0f, +1.0f},
+                                                         BorderMode::SKIP};
+// Sharpen and emboss sum to 1 and repeat the edge pixels outside the image.
+inline constexpr ConvolutionKernel<3> Sharpen_Kernel = {{0.0f, -1.0f, 0.0f, -1.0f, 5.0f, -1.0f, 0.0f, -1.0f, 0.0f},
+                                                        BorderMode::CLAMP};
+inline constexpr ConvolutionKernel<3> Emboss_Kernel = {{-2.0f, -1.0f, 0.0f, -1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 2.0f},
+                                                       BorderMode::CLAMP};
+// Binomial approximation of a Gaussian (sigma ~ 1), renormalised near the border like the box blur.
+inline constexpr ConvolutionKernel<5> Gaussian_5x5_Kernel = {
+    {1.0f, 4.0f,  6.0f,  4.0f,  1.0f, 4.0f, 16.0f, 24.0f, 16.0f, 4.0f, 6.0f, 24.0f, 36.0f,
+     24.0f, 6.0f, 4.0f, 16.0f, 24.0f, 16.0f, 4.0f, 1.0f, 4.0f,  6.0f,  4.0f,  1.0f},
+    BorderMode::SKIP};
+
 ////
 /// Blur image
 //
-auto blur(auto& Image_Span)
+auto blur(auto& Image_Span, Arena_t& Scratch) -> void
 {
-  ////
-  /// Create unique_ptr to an array of RGBTRIPLE to use as reference copy
-  //
-  auto Image_Ref = std::unique_ptr<RGBTRIPLE[]>(new RGBTRIPLE[Image_Span.extent(0) * Image_Span.extent(1)]);
+  convolve<Box_Blur_Kernel>(Image_Span, Scratch, weighted_mean);
+}
 
+////
+/// Find edges image
+//
+auto edges(auto& Image_Span, Arena_t& Scratch) -> void
+{
   ////
-  /// Create mdspan of Image_Ref with same dimensions as Image_Span
+  /// Combine the GX and GY sums of one channel
   //
-  auto Img_Ref_Span = std::mdspan(Image_Ref.get(), Image_Span.extent(0), Image_Span.extent(1));
-  assert(Image_Span.extent(0) == Img_Ref_Span.extent(0) && Image_Span.extent(1) == Img_Ref_Span.extent(1));
+  auto sobel_formula = [](const auto& GX_Sum, const auto& GY_Sum) -> std::uint8_t {
+    // Square GX and GY
+    const float GX = std::pow(static_cast<float>(GX_Sum.Value), 2.0f);
+    const float GY = std::pow(static_cast<float>(GY_Sum.Value), 2.0f);
+    // Combine and round GX and GY
+    const float Pixel_Value = std::round(std::sqrt(GX * GX + GY * GY));
+    // clamp values to 255
+    return Pixel_Value > 255.0f ? 255 : float_to_int(Pixel_Value);
+  };
 
-  ////
-  /// Copy image to reference span
-  //
-  copy_mdspan(Image_Span, Img_Ref_Span);
+  convolve<Sobel_GX_Kernel, Sobel_GY_Kernel>(Image_Span, Scratch, sobel_formula);
+}
 
-  ////
-  /// Useful constants
-  //
-  const auto IMAGE_HEIGHT = Image_Span.extent(0);
-  const auto IMAGE_WIDTH = Image_Span.extent(1);
+////
+/// Sharpen image
+//
+auto sharpen(auto& Image_Span, Arena_t& Scratch) -> void
+{
+  convolve<Sharpen_Kernel>(Image_Span, Scratch, weighted_mean);
+}
 
-  ////
-  /// Pixel state machine to track position
-  //
-  PixelPositionFSM Current_Pixel_State(IMAGE_HEIGHT, IMAGE_WIDTH);
+////
+/// Emboss image
+//
+auto emboss(auto& Image_Span, Arena_t& Scratch) -> void
+{
+  convolve<Emboss_Kernel>(Image_Span, Scratch, weighted_mean);
+}
 
-  ////
-  /// Iterate over all pixels
-  //
-  for (auto [Row_Pos, Col_Pos] : index_mdspan(Image_Span)) {
-    ////
-    /// Declare named lambdas for channel separation
-    //
-    auto blue_channel_func = [](const int Acc, const RGBTRIPLE& Triple) {
-      return Acc + Triple.rgbtBlue;
-    };
-    auto green_channel_func = [](const int Acc, const RGBTRIPLE& Triple) {
-      return Acc + Triple.rgbtGreen;
-    };
-    auto red_channel_func = [](const int Acc, const RGBTRIPLE& Triple) {
-      return Acc + Triple.rgbtRed;
-    };
+////
+/// Gaussian blur image (5x5)
+//
+auto gaussian_blur(auto& Image_Span, Arena_t& Scratch) -> void
+{
+  convolve<Gaussian_5x5_Kernel>(Image_Span, Scratch, weighted_mean);
+}
 
-    ////
-    /// Blur one pixel using provided RGB channel lambdas
-    //
-    auto blur_pixel_formula = [&](auto& Pixels_To_Blur)-> RGBTRIPLE {
-      return RGBTRIPLE{
-          static_cast<std::uint8_t>(
-            std::round(std::accumulate(Pixels_To_Blur.begin(), Pixels_To_Blur.end(), 0, blue_channel_func) /
-                       static_cast<float>(Pixels_To_Blur.size()))),
-          static_cast<std::uint8_t>(
-            std::round(std::accumulate(Pixels_To_Blur.begin(), Pixels_To_Blur.end(), 0, green_channel_func) /
-                       static_cast<float>(Pixels_To_Blur.size()))),
-          static_cast<std::uint8_t>(
-            std::round(std::accumulate(Pixels_To_Blur.begin(), Pixels_To_Blur.end(), 0, red_channel_func) /
-                       static_cast<float>(Pixels_To_Blur.size())))};
-    };
+////
+/// Planar overloads
+//
+// The same filters on a PlanarImage. Every kernel walks contiguous, aligned channel rows with integer arithmetic
+// where the packed version rounds through float, so the inner loops vectorize. The results are identical to the
+// packed filters above, so a run can convert to planar once and apply several filters before converting back.
+//
 
-    ////
-    /// Act on position state
-    //
-    switch (Current_Pixel_State()) {
-        [[unlikely]] case PositionType::UL: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos, Col_Pos], Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                                     Img_Ref_Span[Row_Pos + 1, Col_Pos], Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
-      }
-      break;
+////
+/// Convert Image to greyscale
+//
+inline auto grey_scale(PlanarImage& Image) -> void
+{
+  const auto Width = Image.width();
+  for (std::size_t Row_Pos = 0; Row_Pos < Image.height(); ++Row_Pos) {
+    auto* Blue = Image.row(Channel::BLUE, Row_Pos);
+    auto* Green = Image.row(Channel::GREEN, Row_Pos);
+    auto* Red = Image.row(Channel::RED, Row_Pos);
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      // Sum / 3 never ends in .5, so (Sum + 1) / 3 equals std::round(Sum / 3.0f)
+      const unsigned Sum = Blue[Col_Pos] + Green[Col_Pos] + Red[Col_Pos];
+      const auto Grey = static_cast<std::uint8_t>((Sum + 1) / 3);
+      Blue[Col_Pos] = Grey;
+      Green[Col_Pos] = Grey;
+      Red[Col_Pos] = Grey;
+    }
+  }
+}
 
-        [[unlikely]] case PositionType::TR: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos, Col_Pos - 1], Img_Ref_Span[Row_Pos, Col_Pos],
-                                     Img_Ref_Span[Row_Pos, Col_Pos + 1], Img_Ref_Span[Row_Pos + 1, Col_Pos - 1],
-                                     Img_Ref_Span[Row_Pos + 1, Col_Pos], Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
-      }
-      break;
+////
+/// Reflect image horizontally
+//
+inline auto reflect(PlanarImage& Image) -> void
+{
+  for (const auto Plane : Channels) {
+    for (std::size_t Row_Pos = 0; Row_Pos < Image.height(); ++Row_Pos) {
+      auto* Row = Image.row(Plane, Row_Pos);
+      std::reverse(Row, Row + Image.width());
+    }
+  }
+}
 
-        [[unlikely]] case PositionType::UR: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos, Col_Pos - 1], Img_Ref_Span[Row_Pos, Col_Pos],
-                                     Img_Ref_Span[Row_Pos + 1, Col_Pos - 1], Img_Ref_Span[Row_Pos + 1, Col_Pos]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
-      }
-      break;
+////
+/// Convert image to sepia
+//
+inline auto sepia(PlanarImage& Image) -> void
+{
+  static constexpr auto Sepia_Kernel = std::mdspan(Sepia_Coefficients.cbegin(), 3, 3);
+  auto float_color_to_uint8_t = [](const float Color) {
+    return static_cast<std::uint8_t>(std::clamp(std::round(Color), 0.0f, 255.0f));
+  };
 
-        [[unlikely]] case PositionType::LE: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos - 1, Col_Pos], Img_Ref_Span[Row_Pos - 1, Col_Pos + 1],
-                                     Img_Ref_Span[Row_Pos, Col_Pos], Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                                     Img_Ref_Span[Row_Pos + 1, Col_Pos], Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
-      }
-      break;
-
-        [[likely]] case PositionType::GC: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos - 1, Col_Pos - 1], Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                                     Img_Ref_Span[Row_Pos - 1, Col_Pos + 1], Img_Ref_Span[Row_Pos, Col_Pos - 1],
-                                     Img_Ref_Span[Row_Pos, Col_Pos], Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                                     Img_Ref_Span[Row_Pos + 1, Col_Pos - 1], Img_Ref_Span[Row_Pos + 1, Col_Pos],
-                                     Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
-      }
-      break;
+  const auto Width = Image.width();
+  for (std::size_t Row_Pos = 0; Row_Pos < Image.height(); ++Row_Pos) {
+    auto* Blue = Image.row(Channel::BLUE, Row_Pos);
+    auto* Green = Image.row(Channel::GREEN, Row_Pos);
+    auto* Red = Image.row(Channel::RED, Row_Pos);
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      const std::uint8_t In_Blue = Blue[Col_Pos];
+      const std::uint8_t In_Green = Green[Col_Pos];
+      const std::uint8_t In_Red = Red[Col_Pos];
+      Blue[Col_Pos] = float_color_to_uint8_t(In_Blue * Sepia_Kernel[0, 0] + In_Green * Sepia_Kernel[0, 1] +
+                                             In_Red * Sepia_Kernel[0, 2]);
+      Green[Col_Pos] = float_color_to_uint8_t(In_Blue * Sepia_Kernel[1, 0] + In_Green * Sepia_Kernel[1, 1] +
+                                              In_Red * Sepia_Kernel[1, 2]);
+      Red[Col_Pos] = float_color_to_uint8_t(In_Blue * Sepia_Kernel[2, 0] + In_Green * Sepia_Kernel[2, 1] +
+                                            In_Red * Sepia_Kernel[2, 2]);
+    }
+  }
+}
 
-        [[unlikely]] case PositionType::RE: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos - 1, Col_Pos - 1], Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                                     Img_Ref_Span[Row_Pos, Col_Pos - 1], Img_Ref_Span[Row_Pos, Col_Pos],
-                                     Img_Ref_Span[Row_Pos + 1, Col_Pos - 1], Img_Ref_Span[Row_Pos + 1, Col_Pos]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
-      }
-      break;
+////
+/// Blur image
+//
+// Separable 3x3 box filter per plane: column sums of the (up to) three source rows, then a horizontal 3-tap sum.
+// Source rows above the current one are already overwritten, so the previous and current source rows are kept
+// in two scratch rows.
+//
+inline auto blur(PlanarImage& Image, Arena_t& Scratch) -> void
+{
+  const auto Height = Image.height();
+  const auto Width = Image.width();
 
-        [[unlikely]] case PositionType::LL: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos - 1, Col_Pos], Img_Ref_Span[Row_Pos - 1, Col_Pos + 1],
-                                     Img_Ref_Span[Row_Pos, Col_Pos], Img_Ref_Span[Row_Pos, Col_Pos + 1]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
-      }
-      break;
+  // Rounded mean; Sum / Count never lies within float error of .5 unless it is exactly .5,
+  // so this equals std::round(Sum / static_cast<float>(Count))
+  constexpr auto box_mean = [](const unsigned Sum, const unsigned Count) noexcept {
+    return static_cast<std::uint8_t>((2 * Sum + Count) / (2 * Count));
+  };
+
+  const ArenaScope Scope(Scratch);
+  auto Source_Rows = Scratch.allocate<std::uint8_t>(2 * Width);
+  auto Column_Sums = Scratch.allocate<std::uint16_t>(Width);
 
-        [[unlikely]] case PositionType::BR: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos - 1, Col_Pos - 1], Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                                     Img_Ref_Span[Row_Pos - 1, Col_Pos + 1], Img_Ref_Span[Row_Pos, Col_Pos - 1],
-                                     Img_Ref_Span[Row_Pos, Col_Pos], Img_Ref_Span[Row_Pos, Col_Pos + 1]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
+  for (const auto Plane : Channels) {
+    auto* Prev_Row = Source_Rows.data();
+    auto* Curr_Row = Source_Rows.data() + Width;
+    std::copy_n(Image.row(Plane, 0), Width, Curr_Row);
+
+    for (std::size_t Row_Pos = 0; Row_Pos < Height; ++Row_Pos) {
+      const bool Has_Above = Row_Pos > 0;
+      const bool Has_Below = Row_Pos + 1 < Height;
+      const auto* Below_Row = Has_Below ? Image.row(Plane, Row_Pos + 1) : nullptr;
+      auto* Out_Row = Image.row(Plane, Row_Pos);
+
+      std::copy_n(Curr_Row, Width, Column_Sums.data());
+      if (Has_Above) {
+        for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) { Column_Sums[Col_Pos] += Prev_Row[Col_Pos]; }
+      }
+      if (Has_Below) {
+        for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) { Column_Sums[Col_Pos] += Below_Row[Col_Pos]; }
       }
-      break;
 
-        [[unlikely]] case PositionType::LR: {
-        std::array Pixels_To_Blur = {Img_Ref_Span[Row_Pos - 1, Col_Pos - 1], Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                                     Img_Ref_Span[Row_Pos, Col_Pos - 1], Img_Ref_Span[Row_Pos, Col_Pos]};
-        Image_Span[Row_Pos, Col_Pos] = blur_pixel_formula(Pixels_To_Blur);
+      const unsigned Rows = 1u + Has_Above + Has_Below;
+      if (Width == 1) {
+        Out_Row[0] = box_mean(Column_Sums[0], Rows);
+      }
+      else {
+        Out_Row[0] = box_mean(Column_Sums[0] + Column_Sums[1], 2 * Rows);
+        if (Rows == 3) [[likely]] {
+          for (std::size_t Col_Pos = 1; Col_Pos + 1 < Width; ++Col_Pos) {
+            Out_Row[Col_Pos] =
+                box_mean(Column_Sums[Col_Pos - 1] + Column_Sums[Col_Pos] + Column_Sums[Col_Pos + 1], 9);
+          }
+        }
+        else {
+          for (std::size_t Col_Pos = 1; Col_Pos + 1 < Width; ++Col_Pos) {
+            Out_Row[Col_Pos] =
+                box_mean(Column_Sums[Col_Pos - 1] + Column_Sums[Col_Pos] + Column_Sums[Col_Pos + 1], 3 * Rows);
+          }
+        }
+        Out_Row[Width - 1] = box_mean(Column_Sums[Width - 2] + Column_Sums[Width - 1], 2 * Rows);
       }
-      break;
-    }
 
-    ////
-    /// Advance position state
-    //
-    ++Current_Pixel_State;
+      // Slide the source window down before the next row is overwritten
+      std::swap(Prev_Row, Curr_Row);
+      if (Has_Below) { std::copy_n(Below_Row, Width, Curr_Row); }
+    }
   }
 }
 
 ////
 /// Find edges image
 //
-auto edges(auto& Image_Span) -> void
+// Sobel per plane with black (zero) outside the image, split into a vertical pass (smooth for GX, difference for
+// GY) and a horizontal pass. The sums are exact integers; the final combination repeats the float expression of
+// the packed edges(), which squares each Sobel sum before combining, so both produce the same bytes.
+//
+inline auto edges(PlanarImage& Image, Arena_t& Scratch) -> void
 {
-  ////
-  /// Setup Sobel GX and GY kernels
-  //
-  constexpr std::array GX_Kernel{-1.0f, 0.0f, +1.0f, -2.0f, 0.0f, +2.0f, -1.0f, 0.0f, +1.0f};
-  constexpr std::array GY_Kernel{-1.0f, -2.0f, -1.0f, 0.0f, 0.0f, 0.0f, +1.0f, +2.0f, +1.0f};
-  ////
-  /// Lambda for applying the Sobel kernel
-  //
-  auto g_sobel_kernel = [&](const auto& Pixel_Array, const auto& Convolution) {
-    std::tuple G_Sobel_Val{0.0f, 0.0f, 0.0f}; // Initialize tuple to black
-    std::size_t Pos = 0;
-    auto& [G_Sobel_Blue, G_Sobel_Green, G_Sobel_Red] = G_Sobel_Val;
-    for (const auto& Current_Pixel : Pixel_Array) {
-      auto& [PixelBlue, PixelGreen, PixelRed] = Current_Pixel;
-      G_Sobel_Blue += Convolution.at(Pos) * PixelBlue;
-      G_Sobel_Green += Convolution.at(Pos) * PixelGreen;
-      G_Sobel_Red += Convolution.at(Pos) * PixelRed;
-      ++Pos;
-    }
-    // Square blue, green, and red
-    G_Sobel_Blue = std::pow(G_Sobel_Blue, 2.0f);
-    G_Sobel_Green = std::pow(G_Sobel_Green, 2.0f);
-    G_Sobel_Red = std::pow(G_Sobel_Red, 2.0f);
-    return G_Sobel_Val;
+  const auto Height = Image.height();
+  const auto Width = Image.width();
+
+  const ArenaScope Scope(Scratch);
+  auto Source_Rows = Scratch.allocate<std::uint8_t>(2 * Width);
+  auto Vertical_Smooth = Scratch.allocate<std::int16_t>(Width + 2);  // [1 2 1]^T, zero column on each side
+  auto Vertical_Diff = Scratch.allocate<std::int16_t>(Width + 2);    // [-1 0 1]^T, zero column on each side
+  std::ranges::fill(Vertical_Smooth, std::int16_t{0});
+  std::ranges::fill(Vertical_Diff, std::int16_t{0});
+
+  auto sobel_magnitude = [](const std::int32_t GX_Sum, const std::int32_t GY_Sum) -> std::uint8_t {
+    const auto GX = static_cast<float>(GX_Sum * GX_Sum);
+    const auto GY = static_cast<float>(GY_Sum * GY_Sum);
+    const float Magnitude = std::round(std::sqrt(GX * GX + GY * GY));
+    return Magnitude > 255.0f ? 255 : float_to_int(Magnitude);
   };
-  ////
-  /// Combine and round GX and GY
-  //
-  auto Combine_GX_GY = [](const float GX, const float GY) {
-    return std::round(std::sqrt(GX * GX + GY * GY));
-  };
-  ////
-  /// Lambda for combining GX and GY results
-  //
-  auto sobel_formula = [&](const auto& Pixel_Array) {
-    auto GX = g_sobel_kernel(Pixel_Array, GX_Kernel);
-    auto GY = g_sobel_kernel(Pixel_Array, GY_Kernel);
-    auto& [Blue_GX, Green_GX, Red_GX] = GX;
-    auto& [Blue_GY, Green_GY, Red_GY] = GY;
 
-    std::tuple Intermediate{0.0f, 0.0f, 0.0f};
-    auto& [Pixel_Blue, Pixel_Green, Pixel_Red] = Intermediate;
+  for (const auto Plane : Channels) {
+    auto* Prev_Row = Source_Rows.data();
+    auto* Curr_Row = Source_Rows.data() + Width;
+    std::fill_n(Prev_Row, Width, std::uint8_t{0});
+    std::copy_n(Image.row(Plane, 0), Width, Curr_Row);
+
+    for (std::size_t Row_Pos = 0; Row_Pos < Height; ++Row_Pos) {
+      const bool Has_Below = Row_Pos + 1 < Height;
+      const auto* Below_Row = Has_Below ? Image.row(Plane, Row_Pos + 1) : nullptr;
+      auto* Out_Row = Image.row(Plane, Row_Pos);
+
+      for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+        const std::int16_t Below = Has_Below ? Below_Row[Col_Pos] : 0;
+        Vertical_Smooth[Col_Pos + 1] = static_cast<std::int16_t>(Prev_Row[Col_Pos] + 2 * Curr_Row[Col_Pos] + Below);
+        Vertical_Diff[Col_Pos + 1] = static_cast<std::int16_t>(Below - Prev_Row[Col_Pos]);
+      }
 
-    // Combine GX and GY using square root
-    Pixel_Blue = Combine_GX_GY(Blue_GX, Blue_GY);
-    Pixel_Green = Combine_GX_GY(Green_GX, Green_GY);
-    Pixel_Red = Combine_GX_GY(Red_GX, Red_GY);
+      for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+        const std::int32_t GX_Sum = Vertical_Smooth[Col_Pos + 2] - Vertical_Smooth[Col_Pos];
+        const std::int32_t GY_Sum = Vertical_Diff[Col_Pos] + 2 * Vertical_Diff[Col_Pos + 1] + Vertical_Diff[Col_Pos + 2];
+        Out_Row[Col_Pos] = sobel_magnitude(GX_Sum, GY_Sum);
+      }
 
-    RGBTRIPLE Ret_Val = {};
-    auto& [Ret_Blue, Ret_Green, Ret_Red] = Ret_Val;
+      // Slide the source window down before the next row is overwritten
+      std::swap(Prev_Row, Curr_Row);
+      if (Has_Below) { std::copy_n(Below_Row, Width, Curr_Row); }
+    }
+  }
+}
 
-    // clamp values to 255
-    Ret_Blue = Pixel_Blue > 255.0f ? 255 : float_to_int(Pixel_Blue);
-    Ret_Green = Pixel_Green > 255.0f ? 255 : float_to_int(Pixel_Green);
-    Ret_Red = Pixel_Red > 255.0f ? 255 : float_to_int(Pixel_Red);
+// Arena space the planar blur() and edges() take for an image Width pixels wide
+constexpr auto planar_row_scratch_bytes(const std::size_t Width) noexcept
+{
+  const auto Border_Row_Bytes = Arena_t::bytes_for<std::int16_t>(std::add_sat(Width, std::size_t{2}));
+  return std::add_sat(Arena_t::bytes_for<std::uint8_t>(std::mul_sat(Width, std::size_t{2})),
+                      std::mul_sat(Border_Row_Bytes, std::size_t{2}));
+}
 
-    return Ret_Val;
-  };
+////
+/// Flip image vertically and rotate image by 180°
+//
+inline auto flip_vertical(PlanarImage& Image) -> void
+{
+  for (const auto Plane : Channels) {
+    auto Plane_Span = Image.plane(Plane);
+    flip_vertical(Plane_Span);
+  }
+}
 
-  // Create unique_ptr to an array of RGBTRIPLE to use as a Reference copy
-  auto Image_Ref = std::make_unique<RGBTRIPLE[]>(Image_Span.extent(0) * Image_Span.extent(1));
-  auto Img_Ref_Span = std::mdspan(Image_Ref.get(), Image_Span.extent(0), Image_Span.extent(1));
-  assert(Image_Span.extent(0) == Img_Ref_Span.extent(0) && Image_Span.extent(1) == Img_Ref_Span.extent(1));
+inline auto rotate_180(PlanarImage& Image) -> void
+{
+  for (const auto Plane : Channels) {
+    auto Plane_Span = Image.plane(Plane);
+    rotate_180(Plane_Span);
+  }
+}
 
-  ////
-  /// Copy image to reference span
-  //
-  copy_mdspan(Image_Span, Img_Ref_Span);
+////
+/// Sharpen, emboss and Gaussian blur image
+//
+// These run the convolution engine on each plane separately.
+//
+inline auto sharpen(PlanarImage& Image, Arena_t& Scratch) -> void
+{
+  for (const auto Plane : Channels) {
+    auto Plane_Span = Image.plane(Plane);
+    convolve<Sharpen_Kernel>(Plane_Span, Scratch, weighted_mean);
+  }
+}
 
-  const auto Image_Height = Image_Span.extent(0);
-  const auto Image_Width = Image_Span.extent(1);
-  PixelPositionFSM Current_Pixel_State(Image_Height, Image_Width);
-  constexpr RGBTRIPLE BLACK_TRIPLE{0, 0, 0};
+inline auto emboss(PlanarImage& Image, Arena_t& Scratch) -> void
+{
+  for (const auto Plane : Channels) {
+    auto Plane_Span = Image.plane(Plane);
+    convolve<Emboss_Kernel>(Plane_Span, Scratch, weighted_mean);
+  }
+}
 
-  // Process each pixel in the image
-  for (auto [Row_Pos, Col_Pos] : index_mdspan(Image_Span)) {
-    // Handle different pixel positions (UL, TR, UR, etc.)
-    std::array Pixel_To_SobelGXY = [&] {
-      switch (Current_Pixel_State()) {
-          [[unlikely]] case PositionType::UL:
-          return std::array{BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos, Col_Pos],
-                            Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                            BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos],
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-          [[unlikely]] case PositionType::TR:
-          return std::array{BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos, Col_Pos],
-                            Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos],
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-          [[unlikely]] case PositionType::UR:
-          return std::array{BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos, Col_Pos],
-                            BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos],
-                            BLACK_TRIPLE};
-          [[unlikely]] case PositionType::LE:
-          return std::array{BLACK_TRIPLE, Img_Ref_Span[Row_Pos - 1, Col_Pos], Img_Ref_Span[Row_Pos - 1, Col_Pos + 1],
-                            BLACK_TRIPLE, Img_Ref_Span[Row_Pos, Col_Pos], Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                            BLACK_TRIPLE, Img_Ref_Span[Row_Pos + 1, Col_Pos], Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-          [[likely]] case PositionType::GC:
-          return std::array{Img_Ref_Span[Row_Pos - 1, Col_Pos - 1], Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                            Img_Ref_Span[Row_Pos - 1, Col_Pos + 1], Img_Ref_Span[Row_Pos, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos, Col_Pos], Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos - 1], Img_Ref_Span[Row_Pos + 1, Col_Pos],
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos + 1]};
-          [[unlikely]] case PositionType::RE:
-          return std::array{Img_Ref_Span[Row_Pos - 1, Col_Pos - 1], Img_Ref_Span[Row_Pos - 1, Col_Pos], BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos, Col_Pos - 1], Img_Ref_Span[Row_Pos, Col_Pos], BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos + 1, Col_Pos - 1], Img_Ref_Span[Row_Pos + 1, Col_Pos], BLACK_TRIPLE};
-          [[unlikely]] case PositionType::LL:
-          return std::array{BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                            Img_Ref_Span[Row_Pos - 1, Col_Pos + 1],
-                            BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos, Col_Pos],
-                            Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE};
-          [[unlikely]] case PositionType::BR:
-          return std::array{Img_Ref_Span[Row_Pos - 1, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                            Img_Ref_Span[Row_Pos - 1, Col_Pos + 1],
-                            Img_Ref_Span[Row_Pos, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos, Col_Pos],
-                            Img_Ref_Span[Row_Pos, Col_Pos + 1],
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE};
-          [[unlikely]] case PositionType::LR:
-          return std::array{Img_Ref_Span[Row_Pos - 1, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos - 1, Col_Pos],
-                            BLACK_TRIPLE,
-                            Img_Ref_Span[Row_Pos, Col_Pos - 1],
-                            Img_Ref_Span[Row_Pos, Col_Pos],
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE,
-                            BLACK_TRIPLE};
-        default:
-          std::println("Unexpected PositionType");
-          std::abort();
-          //throw std::runtime_error("Unexpected PositionType");
-      }
-    }();
-    // Apply the Sobel formula
-    Image_Span[Row_Pos, Col_Pos] = sobel_formula(Pixel_To_SobelGXY);
-    // Update pixel state
-    ++Current_Pixel_State;
+inline auto gaussian_blur(PlanarImage& Image, Arena_t& Scratch) -> void
+{
+  for (const auto Plane : Channels) {
+    auto Plane_Span = Image.plane(Plane);
+    convolve<Gaussian_5x5_Kernel>(Plane_Span, Scratch, weighted_mean);
   }
 }
 
@@ -0,0 +1,148 @@
+#ifndef ORIENTATION_HXX
+#define ORIENTATION_HXX
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "bmp.hxx"
+#include "simd.hxx"
+
+////
+/// Scanline primitives for reflect, vertical flip and 180° rotation
+//
+// reverse_scanline() reverses the pixel order of one row in place. Packed rows are reversed 16 pixels (48 bytes,
+// three SSE registers) at a time, taking one block from each end and moving towards the middle, so no RGBTRIPLE is
+// touched one at a time except for the leftover middle. swap_scanlines() exchanges two rows with block moves.
+// for_each_row_batch() spreads independent rows over the hardware threads.
+//
+
+namespace orientation_detail
+{
+using simd_detail::BLOCK_PIXELS;
+using simd_detail::ShuffleMask;
+using simd_detail::ShuffleTable;
+using simd_detail::ZERO_LANE;
+
+// Mask moving the bytes of input chunk M that belong in output chunk K of a 16-pixel reversal
+consteval auto reverse_mask(const std::size_t K, const std::size_t M)
+{
+  ShuffleMask Mask = {};
+  for (std::size_t Byte = 0; Byte < Mask.size(); ++Byte) {
+    const auto Dst = 16 * K + Byte;
+    const auto Src = 3 * (BLOCK_PIXELS - 1 - Dst / 3) + Dst % 3;
+    Mask[Byte] = Src / 16 == M ? static_cast<std::int8_t>(Src % 16) : ZERO_LANE;
+  }
+  return Mask;
+}
+
+inline constexpr ShuffleTable Reverse_Masks = {{
+    {reverse_mask(0, 0), reverse_mask(0, 1), reverse_mask(0, 2)},
+    {reverse_mask(1, 0), reverse_mask(1, 1), reverse_mask(1, 2)},
+    {reverse_mask(2, 0), reverse_mask(2, 1), reverse_mask(2, 2)},
+}};
+
+#if defined(__SSSE3__)
+// Store the 16 pixels of In in reverse order
+inline auto store_reversed_block(const auto& In, std::uint8_t* Block) noexcept -> void
+{
+  for (std::size_t K = 0; K < In.size(); ++K) {
+    _mm_storeu_si128(std::bit_cast<__m128i*>(Block + simd_detail::CHUNK_BYTES * K),
+                     simd_detail::shuffle3(In, Reverse_Masks[K]));
+  }
+}
+#endif
+}  // namespace orientation_detail
+
+////
+/// Reverse the pixels of one packed scanline in place
+//
+inline auto reverse_scanline(RGBTRIPLE* Scanline, const std::size_t Width) noexcept -> void
+{
+  std::size_t Left = 0;
+  std::size_t Right = Width;
+#if defined(__SSSE3__)
+  using namespace orientation_detail;
+  auto* Bytes = std::bit_cast<std::uint8_t*>(Scanline);
+  while (Right - Left >= 2 * BLOCK_PIXELS) {
+    auto* Left_Block = Bytes + 3 * Left;
+    auto* Right_Block = Bytes + 3 * (Right - BLOCK_PIXELS);
+    const auto Left_Pixels = simd_detail::load_block(Left_Block);
+    const auto Right_Pixels = simd_detail::load_block(Right_Block);
+    store_reversed_block(Right_Pixels, Left_Block);
+    store_reversed_block(Left_Pixels, Right_Block);
+    Left += BLOCK_PIXELS;
+    Right -= BLOCK_PIXELS;
+  }
+#endif
+  // Middle (or the whole row without SSSE3)
+  std::reverse(Scanline + Left, Scanline + Right);
+}
+
+////
+/// Reverse one row of a channel plane in place; plain byte reversal vectorizes on its own
+//
+inline auto reverse_scanline(std::uint8_t* Row, const std::size_t Width) noexcept -> void
+{
+  std::reverse(Row, Row + Width);
+}
+
+////
+/// Exchange two non-overlapping rows of Bytes bytes through a small stack buffer
+//
+inline auto swap_scanlines(void* Row_A, void* Row_B, const std::size_t Bytes) noexcept -> void
+{
+  constexpr std::size_t CHUNK_BYTES = 4096;  // stays in L1
+  std::array<std::byte, CHUNK_BYTES> Chunk;
+  auto* A = static_cast<std::byte*>(Row_A);
+  auto* B = static_cast<std::byte*>(Row_B);
+  for (std::size_t Offset = 0; Offset < Bytes; Offset += CHUNK_BYTES) {
+    const auto Length = std::min(CHUNK_BYTES, Bytes - Offset);
+    std::memcpy(Chunk.data(), A + Offset, Length);
+    std::memcpy(A + Offset, B + Offset, Length);
+    std::memcpy(B + Offset, Chunk.data(), Length);
+  }
+}
+
+////
+/// How for_each_row_batch() spreads rows over threads; the defaults are for real images, the tests shrink them
+//
+struct RowBatching
+{
+  std::size_t Min_Batch_Bytes = std::size_t{1} << 20;  // work a thread needs to pay off
+  std::size_t Max_Threads = 0;                          // 0: one per hardware thread
+};
+
+////
+/// Call Batch_Func(Row_Begin, Row_End) on contiguous batches of [0, Rows), one batch per thread
+//
+// Each batch should carry at least Min_Batch_Bytes of work for a thread to pay off, so small images run on
+// the calling thread only.
+//
+inline auto for_each_row_batch(const std::size_t Rows, const std::size_t Row_Bytes, auto Batch_Func,
+                               const RowBatching Batching = {}) -> void
+{
+  const std::size_t Max_Threads =
+      Batching.Max_Threads != 0 ? Batching.Max_Threads : std::max(1u, std::thread::hardware_concurrency());
+  const std::size_t Threads =
+      std::clamp<std::size_t>(Rows * Row_Bytes / std::max<std::size_t>(Batching.Min_Batch_Bytes, 1), 1,
+                              std::max<std::size_t>(1, std::min(Max_Threads, Rows)));
+  if (Threads == 1) {
+    Batch_Func(std::size_t{0}, Rows);
+    return;
+  }
+
+  const std::size_t Batch_Rows = (Rows + Threads - 1) / Threads;
+  std::vector<std::jthread> Workers;
+  Workers.reserve(Threads - 1);
+  for (std::size_t Begin = Batch_Rows; Begin < Rows; Begin += Batch_Rows) {
+    Workers.emplace_back(Batch_Func, Begin, std::min(Begin + Batch_Rows, Rows));
+  }
+  Batch_Func(std::size_t{0}, std::min(Batch_Rows, Rows));
+  // Workers join when they go out of scope
+}
+#endif  // ORIENTATION_HXX
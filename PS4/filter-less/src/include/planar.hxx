@@ -0,0 +1,219 @@
+#ifndef PLANAR_HXX
+#define PLANAR_HXX
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mdspan>
+#include <numeric>
+
+#include "arena.hxx"
+#include "bmp.hxx"
+#include "simd.hxx"
+
+////
+/// Planar (structure of arrays) image
+//
+// RGBTRIPLE is a packed, unaligned 3-byte struct, so every filter on the packed image works one pixel at a time.
+// PlanarImage keeps blue, green and red in three separate uint8_t planes instead. Each plane row starts on a
+// SIMD_WIDTH boundary and is padded up to Stride bytes, so a row of one channel is a contiguous, aligned run of
+// bytes that the compiler can vectorize. Convert once with to_planar(), run any number of filters on the planes
+// and convert back with from_planar(). The planes are carved out of an Arena_t and live as long as it does.
+//
+enum class Channel : std::uint8_t
+{
+  BLUE,
+  GREEN,
+  RED
+};
+
+inline constexpr std::array Channels = {Channel::BLUE, Channel::GREEN, Channel::RED};
+
+class PlanarImage
+{
+public:
+  static constexpr std::size_t SIMD_WIDTH = 64;  // bytes, one cache line; wide enough for AVX-512
+  static_assert(Arena_t::ALIGNMENT % SIMD_WIDTH == 0, "Arena allocations must start on a SIMD_WIDTH boundary");
+  using Plane_Span = std::mdspan<std::uint8_t, std::dextents<std::size_t, 2>, std::layout_stride>;
+
+private:
+  std::size_t Height_;    // Image height
+  std::size_t Width_;     // Image width in pixels
+  std::size_t Stride_;    // Plane row length in bytes, Width_ rounded up to SIMD_WIDTH
+  std::uint8_t* Planes_;  // Blue, green and red planes back to back, owned by the arena
+
+public:
+  PlanarImage(const std::size_t Height, const std::size_t Width, Arena_t& Arena)
+    : Height_(Height),
+      Width_(Width),
+      Stride_(stride_for(Width)),
+      Planes_(Arena.allocate<std::uint8_t>(Channels.size() * Height * Stride_).data())
+  {
+  }
+
+  // Plane row length for an image Width pixels wide
+  [[nodiscard]] static constexpr auto stride_for(const std::size_t Width) noexcept -> std::size_t
+  {
+    return (Width + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+  }
+
+  // Arena space for the planes of a Height x Width image
+  [[nodiscard]] static constexpr auto arena_bytes(const std::size_t Height, const std::size_t Width) noexcept
+  {
+    return Arena_t::bytes_for<std::uint8_t>(std::mul_sat(Channels.size() * Height, stride_for(Width)));
+  }
+
+  [[nodiscard]] auto height() const noexcept
+  {
+    return Height_;
+  }
+  [[nodiscard]] auto width() const noexcept
+  {
+    return Width_;
+  }
+  [[nodiscard]] auto stride() const noexcept
+  {
+    return Stride_;
+  }
+
+  // Pointer to the first pixel of Row_Pos in the given channel plane, aligned to SIMD_WIDTH
+  [[nodiscard]] auto row(const Channel Plane, const std::size_t Row_Pos) const noexcept -> std::uint8_t*
+  {
+    return Planes_ + (static_cast<std::size_t>(Plane) * Height_ + Row_Pos) * Stride_;
+  }
+
+  // Height x Width view of one channel plane; the row padding is skipped through the stride
+  [[nodiscard]] auto plane(const Channel Plane) const noexcept -> Plane_Span
+  {
+    using Mapping = std::layout_stride::mapping<std::dextents<std::size_t, 2>>;
+    return Plane_Span(row(Plane, 0),
+                      Mapping(std::dextents<std::size_t, 2>(Height_, Width_), std::array<std::size_t, 2>{Stride_, 1}));
+  }
+};
+
+namespace planar_detail
+{
+////
+/// pshufb masks for 16 pixels of a packed BGR scanline, indexed [output chunk][input chunk] (see simd.hxx)
+//
+using simd_detail::ShuffleMask;
+using simd_detail::ShuffleTable;
+using simd_detail::ZERO_LANE;
+
+// Mask gathering channel C of the 16 pixels out of packed chunk K
+consteval auto deinterleave_mask(const std::size_t C, const std::size_t K)
+{
+  ShuffleMask Mask = {};
+  for (std::size_t Pixel = 0; Pixel < Mask.size(); ++Pixel) {
+    const auto Src = 3 * Pixel + C;
+    Mask[Pixel] = Src / 16 == K ? static_cast<std::int8_t>(Src % 16) : ZERO_LANE;
+  }
+  return Mask;
+}
+
+// Mask scattering the 16 values of channel C into packed chunk K
+consteval auto interleave_mask(const std::size_t C, const std::size_t K)
+{
+  ShuffleMask Mask = {};
+  for (std::size_t Byte = 0; Byte < Mask.size(); ++Byte) {
+    const auto Dst = 16 * K + Byte;
+    Mask[Byte] = Dst % 3 == C ? static_cast<std::int8_t>(Dst / 3) : ZERO_LANE;
+  }
+  return Mask;
+}
+
+// Channel plane C from the three packed chunks
+inline constexpr ShuffleTable Deinterleave_Masks = {{
+    {deinterleave_mask(0, 0), deinterleave_mask(0, 1), deinterleave_mask(0, 2)},
+    {deinterleave_mask(1, 0), deinterleave_mask(1, 1), deinterleave_mask(1, 2)},
+    {deinterleave_mask(2, 0), deinterleave_mask(2, 1), deinterleave_mask(2, 2)},
+}};
+
+// Packed chunk K from the blue, green and red registers
+inline constexpr ShuffleTable Interleave_Masks = {{
+    {interleave_mask(0, 0), interleave_mask(1, 0), interleave_mask(2, 0)},
+    {interleave_mask(0, 1), interleave_mask(1, 1), interleave_mask(2, 1)},
+    {interleave_mask(0, 2), interleave_mask(1, 2), interleave_mask(2, 2)},
+}};
+}  // namespace planar_detail
+
+////
+/// Split one packed BMP scanline into the three channel rows
+//
+inline auto unpack_scanline(const RGBTRIPLE* Scanline, const std::size_t Width, std::uint8_t* Blue,
+                            std::uint8_t* Green, std::uint8_t* Red) noexcept -> void
+{
+  const auto* Bytes = std::bit_cast<const std::uint8_t*>(Scanline);
+  std::size_t Col_Pos = 0;
+#if defined(__SSSE3__)
+  using namespace planar_detail;
+  using simd_detail::BLOCK_PIXELS;
+  const std::array<std::uint8_t*, 3> Out = {Blue, Green, Red};
+  for (; Col_Pos + BLOCK_PIXELS <= Width; Col_Pos += BLOCK_PIXELS) {
+    const auto Chunks = simd_detail::load_block(Bytes + 3 * Col_Pos);
+    for (std::size_t C = 0; C < Out.size(); ++C) {
+      _mm_storeu_si128(std::bit_cast<__m128i*>(Out[C] + Col_Pos), simd_detail::shuffle3(Chunks, Deinterleave_Masks[C]));
+    }
+  }
+#endif
+  // Scalar tail (or the whole row without SSSE3)
+  for (; Col_Pos < Width; ++Col_Pos) {
+    Blue[Col_Pos] = Bytes[3 * Col_Pos];
+    Green[Col_Pos] = Bytes[3 * Col_Pos + 1];
+    Red[Col_Pos] = Bytes[3 * Col_Pos + 2];
+  }
+}
+
+////
+/// Merge the three channel rows back into one packed BMP scanline
+//
+inline auto pack_scanline(const std::uint8_t* Blue, const std::uint8_t* Green, const std::uint8_t* Red,
+                          const std::size_t Width, RGBTRIPLE* Scanline) noexcept -> void
+{
+  auto* Bytes = std::bit_cast<std::uint8_t*>(Scanline);
+  std::size_t Col_Pos = 0;
+#if defined(__SSSE3__)
+  using namespace planar_detail;
+  using simd_detail::BLOCK_PIXELS;
+  using simd_detail::CHUNK_BYTES;
+  for (; Col_Pos + BLOCK_PIXELS <= Width; Col_Pos += BLOCK_PIXELS) {
+    const auto In = simd_detail::load_chunks(Blue + Col_Pos, Green + Col_Pos, Red + Col_Pos);
+    auto* Block = Bytes + 3 * Col_Pos;
+    for (std::size_t K = 0; K < In.size(); ++K) {
+      _mm_storeu_si128(std::bit_cast<__m128i*>(Block + CHUNK_BYTES * K),
+                       simd_detail::shuffle3(In, Interleave_Masks[K]));
+    }
+  }
+#endif
+  // Scalar tail (or the whole row without SSSE3)
+  for (; Col_Pos < Width; ++Col_Pos) {
+    Bytes[3 * Col_Pos] = Blue[Col_Pos];
+    Bytes[3 * Col_Pos + 1] = Green[Col_Pos];
+    Bytes[3 * Col_Pos + 2] = Red[Col_Pos];
+  }
+}
+
+////
+/// Convert a packed Height x Width RGBTRIPLE mdspan to planar form, with the planes in Arena
+//
+auto to_planar(const auto& Image_Span, Arena_t& Arena) -> PlanarImage
+{
+  PlanarImage Planar(Image_Span.extent(0), Image_Span.extent(1), Arena);
+  for (std::size_t Row_Pos = 0; Row_Pos < Planar.height(); ++Row_Pos) {
+    unpack_scanline(&Image_Span[Row_Pos, 0], Planar.width(), Planar.row(Channel::BLUE, Row_Pos),
+                    Planar.row(Channel::GREEN, Row_Pos), Planar.row(Channel::RED, Row_Pos));
+  }
+  return Planar;
+}
+
+////
+/// Write a planar image back into a packed Height x Width RGBTRIPLE mdspan
+//
+auto from_planar(const PlanarImage& Planar, auto& Image_Span) -> void
+{
+  for (std::size_t Row_Pos = 0; Row_Pos < Planar.height(); ++Row_Pos) {
+    pack_scanline(Planar.row(Channel::BLUE, Row_Pos), Planar.row(Channel::GREEN, Row_Pos),
+                  Planar.row(Channel::RED, Row_Pos), Planar.width(), &Image_Span[Row_Pos, 0]);
+  }
+}
+#endif  // PLANAR_HXX
@@ -0,0 +1,53 @@
+#ifndef SIMD_HXX
+#define SIMD_HXX
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+////
+/// SSSE3 building blocks shared by the planar conversion and the scanline reversal
+//
+// Both move the bytes of 16 packed pixels (48 bytes, three 16-byte chunks) with pshufb. Every output chunk K
+// gathers its bytes from the three input chunks with three shuffles OR-ed together, so a mask table is indexed
+// Masks[K][M]: the mask applied to input chunk M for output chunk K. A mask byte of ZERO_LANE (high bit set)
+// makes pshufb write zero, so each output byte must be taken from exactly one input chunk.
+//
+namespace simd_detail
+{
+inline constexpr std::size_t CHUNK_BYTES = 16;
+inline constexpr std::size_t BLOCK_PIXELS = 16;  // 48 bytes, three chunks
+inline constexpr std::int8_t ZERO_LANE = -128;
+
+using ShuffleMask = std::array<std::int8_t, CHUNK_BYTES>;
+using ShuffleTable = std::array<std::array<ShuffleMask, 3>, 3>;
+
+#if defined(__SSSE3__)
+// Three unaligned chunks from three addresses
+inline auto load_chunks(const std::uint8_t* Chunk_0, const std::uint8_t* Chunk_1, const std::uint8_t* Chunk_2) noexcept
+{
+  return std::array{_mm_loadu_si128(std::bit_cast<const __m128i*>(Chunk_0)),
+                    _mm_loadu_si128(std::bit_cast<const __m128i*>(Chunk_1)),
+                    _mm_loadu_si128(std::bit_cast<const __m128i*>(Chunk_2))};
+}
+
+// One 48-byte block of packed pixels
+inline auto load_block(const std::uint8_t* Block) noexcept
+{
+  return load_chunks(Block, Block + CHUNK_BYTES, Block + 2 * CHUNK_BYTES);
+}
+
+// Gather one output chunk from the three input chunks In with the masks of one table row
+inline auto shuffle3(const auto& In, const std::array<ShuffleMask, 3>& Masks) noexcept
+{
+  return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(In[0], std::bit_cast<__m128i>(Masks[0])),
+                                   _mm_shuffle_epi8(In[1], std::bit_cast<__m128i>(Masks[1]))),
+                      _mm_shuffle_epi8(In[2], std::bit_cast<__m128i>(Masks[2])));
+}
+#endif
+}  // namespace simd_detail
+#endif  // SIMD_HXX
@@ -0,0 +1,238 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "arena.hxx"
+#include "bmp_io.hxx"
+
+////
+/// In-memory BMP fixtures
+//
+// A fixture is the exact bytes of a small BMP file. Pixel bytes are a function of their position in the image, so
+// the tests can check where read_bmp() put every pixel as well as the bytes write_bmp() produces.
+//
+namespace
+{
+constexpr DWORD V5_HEADER_BYTES = 124;
+
+struct BmpFixture
+{
+  LONG Width = 5;         // 5 pixels: 15 bytes of 24-bit pixels, one byte of padding
+  LONG Height = 3;        // Negative for top-down
+  WORD Bit_Count = 24;
+  DWORD Compression = BI_RGB;
+  DWORD Info_Bytes = sizeof(BITMAPINFOHEADER);
+  std::array<DWORD, 3> Bit_Masks = BGRA_Bit_Masks;  // Written after the info header for BI_BITFIELDS
+  std::optional<DWORD> Off_Bits = std::nullopt;     // Defaults to the end of the headers
+};
+
+// Byte Channel (0 blue, 1 green, 2 red, 3 alpha) of the pixel at (Row_Pos, Col_Pos), top row first
+constexpr auto fixture_byte(const std::size_t Row_Pos, const std::size_t Col_Pos, const std::size_t Channel)
+{
+  return static_cast<std::uint8_t>(61 * Row_Pos + 7 * Col_Pos + 101 * Channel + 1);
+}
+
+auto append(std::vector<std::uint8_t>& Bytes, const auto& Value) -> void
+{
+  const auto* First = reinterpret_cast<const std::uint8_t*>(&Value);
+  Bytes.insert(Bytes.end(), First, First + sizeof(Value));
+}
+
+auto make_bmp(const BmpFixture& Fixture) -> std::vector<std::uint8_t>
+{
+  const bool Has_Masks = Fixture.Compression == BI_BITFIELDS;
+  const std::size_t Header_Bytes =
+      sizeof(BITMAPFILEHEADER) + Fixture.Info_Bytes +
+      (Has_Masks && Fixture.Info_Bytes == sizeof(BITMAPINFOHEADER) ? sizeof(Fixture.Bit_Masks) : 0);
+  const std::size_t Width = Fixture.Width > 0 ? static_cast<std::size_t>(Fixture.Width) : 0;
+  const std::size_t Height = Fixture.Height == INT32_MIN ? 1 : static_cast<std::size_t>(std::abs(Fixture.Height));
+  const std::size_t Pixel_Bytes = Fixture.Bit_Count / 8u;
+  const std::size_t Row_Bytes = (Width * Pixel_Bytes + 3) / 4 * 4;
+
+  const BITMAPFILEHEADER File_Header = {
+      .bfType = BMP_SIGNATURE,
+      .bfSize = static_cast<DWORD>(Header_Bytes + Height * Row_Bytes),
+      .bfReserved1 = 0,
+      .bfReserved2 = 0,
+      .bfOffBits = Fixture.Off_Bits.value_or(static_cast<DWORD>(Header_Bytes)),
+  };
+  const BITMAPINFOHEADER Info_Header = {
+      .biSize = Fixture.Info_Bytes,
+      .biWidth = Fixture.Width,
+      .biHeight = Fixture.Height,
+      .biPlanes = 1,
+      .biBitCount = Fixture.Bit_Count,
+      .biCompression = Fixture.Compression,
+      .biSizeImage = static_cast<DWORD>(Height * Row_Bytes),
+      .biXPelsPerMeter = 2835,
+      .biYPelsPerMeter = 2835,
+      .biClrUsed = 0,
+      .biClrImportant = 0,
+  };
+
+  std::vector<std::uint8_t> Bytes;
+  append(Bytes, File_Header);
+  append(Bytes, Info_Header);
+  if (Has_Masks) { append(Bytes, Fixture.Bit_Masks); }
+  // The rest of a V4/V5 header (alpha mask, colour space, ...) is carried along untouched
+  for (std::uint8_t Filler = 0xa0; Bytes.size() < Header_Bytes; ++Filler) { Bytes.push_back(Filler); }
+
+  // Padding bytes are zero, as write_bmp() writes them
+  const bool Top_Down = Fixture.Height < 0;
+  for (std::size_t File_Row = 0; File_Row < Height; ++File_Row) {
+    const auto Row_Pos = Top_Down ? File_Row : Height - 1 - File_Row;
+    const auto Row_Begin = Bytes.size();
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      for (std::size_t Channel = 0; Channel < Pixel_Bytes; ++Channel) {
+        Bytes.push_back(fixture_byte(Row_Pos, Col_Pos, Channel));
+      }
+    }
+    Bytes.resize(Row_Begin + Row_Bytes, 0);
+  }
+  return Bytes;
+}
+
+using File_Ptr = std::unique_ptr<FILE, decltype([](FILE* Ptr) { fclose(Ptr); })>;
+
+auto open_bytes(const std::vector<std::uint8_t>& Bytes) -> File_Ptr
+{
+  File_Ptr File(tmpfile());
+  REQUIRE(File != nullptr);
+  REQUIRE(fwrite(Bytes.data(), 1, Bytes.size(), File.get()) == Bytes.size());
+  REQUIRE(fseek(File.get(), 0, SEEK_SET) == 0);
+  return File;
+}
+
+auto file_bytes(FILE* File) -> std::vector<std::uint8_t>
+{
+  REQUIRE(fseek(File, 0, SEEK_END) == 0);
+  std::vector<std::uint8_t> Bytes(static_cast<std::size_t>(ftell(File)));
+  REQUIRE(fseek(File, 0, SEEK_SET) == 0);
+  REQUIRE(fread(Bytes.data(), 1, Bytes.size(), File) == Bytes.size());
+  return Bytes;
+}
+
+auto layout_of(const std::vector<std::uint8_t>& Bytes) -> std::optional<BmpLayout>
+{
+  const auto In = open_bytes(Bytes);
+  return read_bmp_layout(In.get());
+}
+
+// Read Fixture, check every pixel landed top row first, write it back and compare the files byte for byte
+auto check_round_trip(const BmpFixture& Fixture) -> void
+{
+  const auto Original = make_bmp(Fixture);
+  const auto In = open_bytes(Original);
+  const auto Layout = read_bmp_layout(In.get());
+  REQUIRE(Layout.has_value());
+  REQUIRE(Layout->Top_Down == (Fixture.Height < 0));
+  REQUIRE(Layout->Bit_Count == Fixture.Bit_Count);
+
+  auto Arena = Arena_t::create(bmp_arena_bytes(*Layout));
+  REQUIRE(Arena.has_value());
+  const auto Image = read_bmp(In.get(), *Layout, *Arena);
+  REQUIRE(Image.has_value());
+  REQUIRE(Arena->used() <= Arena->capacity());
+
+  for (std::size_t Row_Pos = 0; Row_Pos < Layout->Height; ++Row_Pos) {
+    for (std::size_t Col_Pos = 0; Col_Pos < Layout->Width; ++Col_Pos) {
+      const auto& Pixel = Image->Pixels[Row_Pos * Layout->Width + Col_Pos];
+      REQUIRE(Pixel.rgbtBlue == fixture_byte(Row_Pos, Col_Pos, 0));
+      REQUIRE(Pixel.rgbtGreen == fixture_byte(Row_Pos, Col_Pos, 1));
+      REQUIRE(Pixel.rgbtRed == fixture_byte(Row_Pos, Col_Pos, 2));
+      if (Layout->Bit_Count == 32) {
+        REQUIRE(Image->Alpha[Row_Pos * Layout->Width + Col_Pos] == fixture_byte(Row_Pos, Col_Pos, 3));
+      }
+    }
+  }
+
+  File_Ptr Out(tmpfile());
+  REQUIRE(Out != nullptr);
+  REQUIRE(write_bmp(Out.get(), *Image));
+  REQUIRE(file_bytes(Out.get()) == Original);
+}
+}  // namespace
+
+TEST_CASE("24-bit bottom-up BMP with row padding round-trips", "[bmp_io]")
+{
+  check_round_trip({});
+  check_round_trip({.Width = 1, .Height = 1});
+  check_round_trip({.Width = 4, .Height = 2});  // no padding
+}
+
+TEST_CASE("24-bit top-down BMP round-trips", "[bmp_io]")
+{
+  check_round_trip({.Height = -3});
+  check_round_trip({.Width = 7, .Height = -4});
+}
+
+TEST_CASE("32-bit BI_RGB BMP round-trips with its alpha channel", "[bmp_io]")
+{
+  check_round_trip({.Bit_Count = 32});
+  check_round_trip({.Width = 6, .Height = -2, .Bit_Count = 32});
+}
+
+TEST_CASE("32-bit BI_BITFIELDS BMP round-trips", "[bmp_io]")
+{
+  SECTION("V5 header")
+  {
+    check_round_trip({.Bit_Count = 32, .Compression = BI_BITFIELDS, .Info_Bytes = V5_HEADER_BYTES});
+    check_round_trip({.Height = -3, .Bit_Count = 32, .Compression = BI_BITFIELDS, .Info_Bytes = V5_HEADER_BYTES});
+  }
+  SECTION("BITMAPINFOHEADER followed by the masks")
+  {
+    check_round_trip({.Bit_Count = 32, .Compression = BI_BITFIELDS});
+  }
+}
+
+TEST_CASE("Unsupported or malformed BMPs are rejected before allocation", "[bmp_io]")
+{
+  REQUIRE(layout_of(make_bmp({})).has_value());
+
+  SECTION("biHeight == INT32_MIN")
+  {
+    REQUIRE_FALSE(layout_of(make_bmp({.Height = INT32_MIN})).has_value());
+  }
+  SECTION("biWidth <= 0")
+  {
+    REQUIRE_FALSE(layout_of(make_bmp({.Width = 0})).has_value());
+    REQUIRE_FALSE(layout_of(make_bmp({.Width = -5})).has_value());
+  }
+  SECTION("Truncated file")
+  {
+    auto Bytes = make_bmp({});
+    Bytes.pop_back();
+    REQUIRE_FALSE(layout_of(Bytes).has_value());
+    Bytes.resize(sizeof(BITMAPFILEHEADER) + 8);  // cut inside the info header
+    REQUIRE_FALSE(layout_of(Bytes).has_value());
+  }
+  SECTION("BI_BITFIELDS masks other than BGRA")
+  {
+    constexpr std::array<DWORD, 3> RGBA_Bit_Masks = {0x000000ff, 0x0000ff00, 0x00ff0000};
+    REQUIRE_FALSE(layout_of(make_bmp({.Bit_Count = 32,
+                                      .Compression = BI_BITFIELDS,
+                                      .Info_Bytes = V5_HEADER_BYTES,
+                                      .Bit_Masks = RGBA_Bit_Masks}))
+                      .has_value());
+    REQUIRE_FALSE(layout_of(make_bmp({.Bit_Count = 24, .Compression = BI_BITFIELDS})).has_value());
+  }
+  SECTION("bfOffBits inside the headers")
+  {
+    constexpr auto HEADERS = static_cast<DWORD>(sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER));
+    REQUIRE_FALSE(layout_of(make_bmp({.Off_Bits = HEADERS - 1})).has_value());
+    REQUIRE_FALSE(layout_of(make_bmp({.Off_Bits = 0})).has_value());
+    REQUIRE_FALSE(layout_of(make_bmp({.Bit_Count = 32,
+                                      .Compression = BI_BITFIELDS,
+                                      .Info_Bytes = V5_HEADER_BYTES,
+                                      .Off_Bits = HEADERS + sizeof(BGRA_Bit_Masks)}))
+                      .has_value());
+  }
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "convolution.hxx"
+#include "helpers.hxx"
+#include "test_util.hxx"
+
+using filter::test::image_span;
+using filter::test::random_image;
+using filter::test::same_pixels;
+using filter::test::test_arena;
+
+namespace
+{
+////
+/// Naive reference: visit every tap of every pixel with explicit bounds checks
+//
+struct NaiveSum
+{
+  std::array<double, 3> Values{};
+  double Weight = 0.0;
+};
+
+template <ConvolutionKernel Kernel>
+auto naive_sum(const std::vector<RGBTRIPLE>& Image, const std::size_t Height, const std::size_t Width,
+               const std::size_t Row_Pos, const std::size_t Col_Pos) -> NaiveSum
+{
+  NaiveSum Sum;
+  const auto Radius = static_cast<long>(Kernel.RADIUS);
+  for (long Tap_Row = -Radius; Tap_Row <= Radius; ++Tap_Row) {
+    for (long Tap_Col = -Radius; Tap_Col <= Radius; ++Tap_Col) {
+      long Row = static_cast<long>(Row_Pos) + Tap_Row;
+      long Col = static_cast<long>(Col_Pos) + Tap_Col;
+      const bool Inside = Row >= 0 && Row < static_cast<long>(Height) && Col >= 0 && Col < static_cast<long>(Width);
+      if (!Inside && Kernel.Border == BorderMode::SKIP) { continue; }
+      Row = std::clamp(Row, 0l, static_cast<long>(Height) - 1);
+      Col = std::clamp(Col, 0l, static_cast<long>(Width) - 1);
+
+      const double Coefficient =
+          Kernel[static_cast<std::size_t>(Tap_Row + Radius), static_cast<std::size_t>(Tap_Col + Radius)];
+      const auto& Pixel = Image[static_cast<std::size_t>(Row) * Width + static_cast<std::size_t>(Col)];
+      Sum.Values[0] += Coefficient * Pixel.rgbtBlue;
+      Sum.Values[1] += Coefficient * Pixel.rgbtGreen;
+      Sum.Values[2] += Coefficient * Pixel.rgbtRed;
+      Sum.Weight += Coefficient;
+    }
+  }
+  return Sum;
+}
+
+auto to_pixel(const std::array<std::uint8_t, 3>& Channels) -> RGBTRIPLE
+{
+  return RGBTRIPLE{Channels[0], Channels[1], Channels[2]};
+}
+
+// Rounded, clamped weighted mean of every channel
+template <ConvolutionKernel Kernel>
+auto naive_mean(const std::vector<RGBTRIPLE>& Image, const std::size_t Height, const std::size_t Width)
+{
+  std::vector<RGBTRIPLE> Result(Image.size());
+  for (std::size_t Row_Pos = 0; Row_Pos < Height; ++Row_Pos) {
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      const auto Sum = naive_sum<Kernel>(Image, Height, Width, Row_Pos, Col_Pos);
+      std::array<std::uint8_t, 3> Channels = {};
+      for (std::size_t C = 0; C < Channels.size(); ++C) {
+        Channels[C] = static_cast<std::uint8_t>(std::clamp(std::round(Sum.Values[C] / Sum.Weight), 0.0, 255.0));
+      }
+      Result[Row_Pos * Width + Col_Pos] = to_pixel(Channels);
+    }
+  }
+  return Result;
+}
+
+// Sobel with black outside the image; each sum is squared before the two are combined, like edges()
+auto naive_sobel(const std::vector<RGBTRIPLE>& Image, const std::size_t Height, const std::size_t Width)
+{
+  std::vector<RGBTRIPLE> Result(Image.size());
+  for (std::size_t Row_Pos = 0; Row_Pos < Height; ++Row_Pos) {
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      const auto GX = naive_sum<Sobel_GX_Kernel>(Image, Height, Width, Row_Pos, Col_Pos);
+      const auto GY = naive_sum<Sobel_GY_Kernel>(Image, Height, Width, Row_Pos, Col_Pos);
+      std::array<std::uint8_t, 3> Channels = {};
+      for (std::size_t C = 0; C < Channels.size(); ++C) {
+        const auto GX_Squared = static_cast<float>(GX.Values[C] * GX.Values[C]);
+        const auto GY_Squared = static_cast<float>(GY.Values[C] * GY.Values[C]);
+        const float Magnitude = std::round(std::sqrt(GX_Squared * GX_Squared + GY_Squared * GY_Squared));
+        Channels[C] = Magnitude > 255.0f ? 255 : static_cast<std::uint8_t>(Magnitude);
+      }
+      Result[Row_Pos * Width + Col_Pos] = to_pixel(Channels);
+    }
+  }
+  return Result;
+}
+
+// Float path: every coefficient is a power of two, so float and double sums are exact and comparable
+inline constexpr ConvolutionKernel<3> Binomial_Float_Kernel = {
+    {0.25f, 0.5f, 0.25f, 0.5f, 1.0f, 0.5f, 0.25f, 0.5f, 0.25f}, BorderMode::SKIP};
+static_assert(std::is_same_v<Accumulator_t<Binomial_Float_Kernel>, float>);
+
+// Single rows and columns, 2x2, the 5x5 kernel's own size (one interior pixel) and smaller, and larger images
+constexpr std::array<std::array<std::size_t, 2>, 9> Test_Sizes = {
+    {{1, 1}, {1, 9}, {9, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 5}, {6, 9}, {13, 37}}};
+
+template <ConvolutionKernel Kernel>
+auto convolve_matches_naive_mean()
+{
+  for (const auto [Height, Width] : Test_Sizes) {
+    INFO("Image " << Height << "x" << Width);
+    auto Image = random_image(Height, Width, static_cast<std::uint32_t>(Height * 100 + Width));
+    const auto Expected = naive_mean<Kernel>(Image, Height, Width);
+
+    auto Image_Span = image_span(Image, Height, Width);
+    auto Arena = test_arena(Height, Width);
+    convolve<Kernel>(Image_Span, Arena, weighted_mean);
+    REQUIRE(same_pixels(Image, Expected));
+    REQUIRE(Arena.used() == 0);  // the scratch copy is released
+  }
+}
+}  // namespace
+
+TEST_CASE("convolve<Box_Blur_Kernel> matches the naive box blur", "[convolution]")
+{
+  convolve_matches_naive_mean<Box_Blur_Kernel>();
+}
+
+TEST_CASE("convolve<Gaussian_5x5_Kernel> matches the naive Gaussian blur", "[convolution]")
+{
+  convolve_matches_naive_mean<Gaussian_5x5_Kernel>();
+}
+
+TEST_CASE("CLAMP kernels match the naive convolution", "[convolution][clamp]")
+{
+  convolve_matches_naive_mean<Sharpen_Kernel>();
+  convolve_matches_naive_mean<Emboss_Kernel>();
+}
+
+TEST_CASE("float accumulator path matches the naive convolution", "[convolution][float]")
+{
+  convolve_matches_naive_mean<Binomial_Float_Kernel>();
+}
+
+TEST_CASE("the Sobel pair in edges() matches the naive Sobel filter", "[convolution][sobel]")
+{
+  for (const auto [Height, Width] : Test_Sizes) {
+    INFO("Image " << Height << "x" << Width);
+    auto Image = random_image(Height, Width, static_cast<std::uint32_t>(Height * 100 + Width));
+    const auto Expected = naive_sobel(Image, Height, Width);
+
+    auto Image_Span = image_span(Image, Height, Width);
+    auto Arena = test_arena(Height, Width);
+    edges(Image_Span, Arena);
+    REQUIRE(same_pixels(Image, Expected));
+  }
+}
@@ -0,0 +1,136 @@
+// Compile-time checks: this target passes by compiling
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "convolution.hxx"
+#include "helpers.hxx"
+#include "orientation.hxx"
+#include "planar.hxx"
+#include "simd.hxx"
+
+namespace filter::test
+{
+
+////
+/// Convolution kernels and accumulators
+//
+// Kernels with whole-number coefficients accumulate exactly in int32
+static_assert(std::is_same_v<Accumulator_t<Box_Blur_Kernel>, std::int32_t>, "Box blur must accumulate in int32");
+static_assert(std::is_same_v<Accumulator_t<Sobel_GX_Kernel>, std::int32_t>, "Sobel GX must accumulate in int32");
+static_assert(std::is_same_v<Accumulator_t<Sobel_GY_Kernel>, std::int32_t>, "Sobel GY must accumulate in int32");
+static_assert(std::is_same_v<Accumulator_t<Sharpen_Kernel>, std::int32_t>, "Sharpen must accumulate in int32");
+static_assert(std::is_same_v<Accumulator_t<Emboss_Kernel>, std::int32_t>, "Emboss must accumulate in int32");
+static_assert(std::is_same_v<Accumulator_t<Gaussian_5x5_Kernel>, std::int32_t>, "Gaussian must accumulate in int32");
+
+// A single non-integer coefficient switches the kernel to float
+inline constexpr ConvolutionKernel<3> Fractional_Kernel = {{0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.5f, 0.0f, 0.0f, 0.0f}};
+static_assert(std::is_same_v<Accumulator_t<Fractional_Kernel>, float>, "Fractional kernel must accumulate in float");
+static_assert(!Fractional_Kernel.is_integral(), "0.5 is not a whole number");
+
+// Geometry and weights
+static_assert(Box_Blur_Kernel.RADIUS == 1 && Gaussian_5x5_Kernel.RADIUS == 2, "Wrong kernel radius");
+static_assert(Box_Blur_Kernel.weight() == 9.0f, "Box blur weight");
+static_assert(Gaussian_5x5_Kernel.weight() == 256.0f, "Binomial 5x5 weight is 16 * 16");
+static_assert(Sharpen_Kernel.weight() == 1.0f && Emboss_Kernel.weight() == 1.0f, "Sharpen and emboss keep brightness");
+static_assert(Sobel_GX_Kernel.weight() == 0.0f && Sobel_GY_Kernel.weight() == 0.0f, "Sobel kernels sum to zero");
+static_assert(Sobel_GX_Kernel[1, 2] == 2.0f && Sobel_GY_Kernel[2, 1] == 2.0f, "Sobel centre taps");
+
+// Border modes
+static_assert(Box_Blur_Kernel.Border == BorderMode::SKIP && Gaussian_5x5_Kernel.Border == BorderMode::SKIP);
+static_assert(Sharpen_Kernel.Border == BorderMode::CLAMP && Emboss_Kernel.Border == BorderMode::CLAMP);
+
+////
+/// pshufb mask tables
+//
+// The SSSE3 paths are replayed here byte by byte: output chunk K of a 48-byte block is the OR of input chunk M
+// shuffled by Masks[K][M], and a lane of ZERO_LANE contributes zero.
+//
+using Block = std::array<std::uint8_t, 3 * simd_detail::CHUNK_BYTES>;
+
+constexpr auto shuffle_block(const Block& In, const simd_detail::ShuffleTable& Masks)
+{
+  Block Out = {};
+  for (std::size_t K = 0; K < 3; ++K) {
+    for (std::size_t Byte = 0; Byte < simd_detail::CHUNK_BYTES; ++Byte) {
+      std::uint8_t Value = 0;
+      for (std::size_t M = 0; M < 3; ++M) {
+        const auto Lane = Masks[K][M][Byte];
+        if (Lane >= 0) { Value |= In[simd_detail::CHUNK_BYTES * M + static_cast<std::size_t>(Lane)]; }
+      }
+      Out[simd_detail::CHUNK_BYTES * K + Byte] = Value;
+    }
+  }
+  return Out;
+}
+
+// Every lane is an index into a chunk or ZERO_LANE, and every output byte has exactly one source chunk
+constexpr auto one_source_per_byte(const simd_detail::ShuffleTable& Masks)
+{
+  for (std::size_t K = 0; K < 3; ++K) {
+    for (std::size_t Byte = 0; Byte < simd_detail::CHUNK_BYTES; ++Byte) {
+      int Sources = 0;
+      for (std::size_t M = 0; M < 3; ++M) {
+        const auto Lane = Masks[K][M][Byte];
+        if (Lane != simd_detail::ZERO_LANE && (Lane < 0 || Lane >= 16)) { return false; }
+        Sources += Lane >= 0 ? 1 : 0;
+      }
+      if (Sources != 1) { return false; }
+    }
+  }
+  return true;
+}
+
+// Byte I of the input is I, so every output byte names where it came from
+constexpr auto Identity_Block = [] {
+  Block In = {};
+  for (std::size_t Byte = 0; Byte < In.size(); ++Byte) { In[Byte] = static_cast<std::uint8_t>(Byte); }
+  return In;
+}();
+
+// Packed chunks to channel planes: byte P of plane C is byte 3P + C of the packed pixels
+constexpr auto deinterleaves()
+{
+  const auto Out = shuffle_block(Identity_Block, planar_detail::Deinterleave_Masks);
+  for (std::size_t C = 0; C < 3; ++C) {
+    for (std::size_t Pixel = 0; Pixel < simd_detail::BLOCK_PIXELS; ++Pixel) {
+      if (Out[simd_detail::CHUNK_BYTES * C + Pixel] != 3 * Pixel + C) { return false; }
+    }
+  }
+  return true;
+}
+
+// Channel planes back to packed chunks
+constexpr auto interleaves()
+{
+  const auto Planes = shuffle_block(Identity_Block, planar_detail::Deinterleave_Masks);
+  return shuffle_block(Planes, planar_detail::Interleave_Masks) == Identity_Block;
+}
+
+// 16 packed pixels in reverse order, each pixel keeping its byte order
+constexpr auto reverses()
+{
+  const auto Out = shuffle_block(Identity_Block, orientation_detail::Reverse_Masks);
+  for (std::size_t Byte = 0; Byte < Out.size(); ++Byte) {
+    if (Out[Byte] != 3 * (simd_detail::BLOCK_PIXELS - 1 - Byte / 3) + Byte % 3) { return false; }
+  }
+  return true;
+}
+
+static_assert(one_source_per_byte(planar_detail::Deinterleave_Masks), "Deinterleave lane out of range or doubled");
+static_assert(one_source_per_byte(planar_detail::Interleave_Masks), "Interleave lane out of range or doubled");
+static_assert(one_source_per_byte(orientation_detail::Reverse_Masks), "Reverse lane out of range or doubled");
+static_assert(deinterleaves(), "Deinterleave masks do not split BGR into planes");
+static_assert(interleaves(), "Interleave masks do not undo the deinterleave");
+static_assert(reverses(), "Reverse masks do not reverse 16 pixels");
+static_assert(shuffle_block(shuffle_block(Identity_Block, orientation_detail::Reverse_Masks),
+                            orientation_detail::Reverse_Masks) == Identity_Block,
+              "Reversing twice is the identity");
+
+}  // namespace filter::test
+
+int main()
+{
+  return 0;
+}
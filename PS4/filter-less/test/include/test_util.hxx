@@ -0,0 +1,60 @@
+#ifndef FILTER_TEST_UTIL_HXX
+#define FILTER_TEST_UTIL_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mdspan>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "arena.hxx"
+#include "bmp.hxx"
+#include "planar.hxx"
+
+namespace filter::test
+{
+
+// Deterministic pseudo-random Height x Width image
+inline auto random_image(const std::size_t Height, const std::size_t Width, const std::uint32_t Seed = 50)
+    -> std::vector<RGBTRIPLE>
+{
+  std::mt19937 Engine(Seed);
+  std::uniform_int_distribution<int> Byte(0, 255);
+  std::vector<RGBTRIPLE> Image(Height * Width);
+  for (auto& Pixel : Image) {
+    Pixel = RGBTRIPLE{static_cast<std::uint8_t>(Byte(Engine)), static_cast<std::uint8_t>(Byte(Engine)),
+                      static_cast<std::uint8_t>(Byte(Engine))};
+  }
+  return Image;
+}
+
+inline auto image_span(std::vector<RGBTRIPLE>& Image, const std::size_t Height, const std::size_t Width)
+{
+  return std::mdspan(Image.data(), Height, Width);
+}
+
+constexpr auto same_pixel(const RGBTRIPLE& Lhs, const RGBTRIPLE& Rhs) noexcept
+{
+  return Lhs.rgbtBlue == Rhs.rgbtBlue && Lhs.rgbtGreen == Rhs.rgbtGreen && Lhs.rgbtRed == Rhs.rgbtRed;
+}
+
+inline auto same_pixels(const std::vector<RGBTRIPLE>& Lhs, const std::vector<RGBTRIPLE>& Rhs)
+{
+  return std::ranges::equal(Lhs, Rhs, same_pixel);
+}
+
+// Arena large enough for a planar copy of a Height x Width image plus the scratch space of any filter
+inline auto test_arena(const std::size_t Height, const std::size_t Width) -> Arena_t
+{
+  const auto Pixel_Count = std::max<std::size_t>(Height * Width, 1);
+  auto Arena = Arena_t::create(PlanarImage::arena_bytes(Height, Width) + Arena_t::bytes_for<RGBTRIPLE>(Pixel_Count) +
+                               Arena_t::bytes_for<std::int16_t>(4 * (Width + 2)) + Arena_t::bytes_for<std::uint8_t>(2 * Width) +
+                               4 * Arena_t::ALIGNMENT);
+  return std::move(*Arena);
+}
+
+}  // namespace filter::test
+
+#endif  // FILTER_TEST_UTIL_HXX
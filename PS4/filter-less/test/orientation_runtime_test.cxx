@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "helpers.hxx"
+#include "orientation.hxx"
+#include "test_util.hxx"
+
+using filter::test::image_span;
+using filter::test::random_image;
+using filter::test::same_pixels;
+
+TEST_CASE("reverse_scanline matches std::reverse", "[orientation][simd]")
+{
+  // Every width up to 100 covers no block, one block from each end, and all the leftover middles
+  for (std::size_t Width = 0; Width <= 100; ++Width) {
+    INFO("Width " << Width);
+    auto Scanline = random_image(1, Width, static_cast<std::uint32_t>(Width));
+    auto Expected = Scanline;
+    std::ranges::reverse(Expected);
+    reverse_scanline(Scanline.data(), Width);
+    REQUIRE(same_pixels(Scanline, Expected));
+
+    std::vector<std::uint8_t> Row(Width);
+    std::ranges::transform(Scanline, Row.begin(), [](const RGBTRIPLE& Pixel) { return Pixel.rgbtGreen; });
+    auto Expected_Row = Row;
+    std::ranges::reverse(Expected_Row);
+    reverse_scanline(Row.data(), Width);
+    REQUIRE(Row == Expected_Row);
+  }
+}
+
+TEST_CASE("rotate_180 equals reflect followed by flip_vertical", "[orientation]")
+{
+  // Odd heights leave a middle row that is only reversed
+  for (const std::size_t Height : {1u, 2u, 3u, 4u, 7u, 8u}) {
+    for (const std::size_t Width : {1u, 16u, 33u, 70u}) {
+      INFO(Height << "x" << Width);
+      auto Rotated = random_image(Height, Width, static_cast<std::uint32_t>(Height * 1000 + Width));
+      auto Expected = Rotated;
+      auto Rotated_Span = image_span(Rotated, Height, Width);
+      auto Expected_Span = image_span(Expected, Height, Width);
+
+      rotate_180(Rotated_Span);
+      reflect(Expected_Span);
+      flip_vertical(Expected_Span);
+      REQUIRE(same_pixels(Rotated, Expected));
+    }
+  }
+}
+
+TEST_CASE("flip_vertical reverses the row order", "[orientation]")
+{
+  for (const std::size_t Height : {1u, 2u, 5u, 6u}) {
+    constexpr std::size_t WIDTH = 37;
+    INFO("Height " << Height);
+    auto Image = random_image(Height, WIDTH);
+    const auto Original = Image;
+    auto Image_Span = image_span(Image, Height, WIDTH);
+    flip_vertical(Image_Span);
+    for (std::size_t Row_Pos = 0; Row_Pos < Height; ++Row_Pos) {
+      const auto* Expected_Row = Original.data() + (Height - 1 - Row_Pos) * WIDTH;
+      REQUIRE(std::equal(Expected_Row, Expected_Row + WIDTH, &Image_Span[Row_Pos, 0], filter::test::same_pixel));
+    }
+  }
+}
+
+////
+/// Threaded row batches
+//
+// Test images are far below the default Min_Batch_Bytes, so these cases shrink it and fix the thread count; the
+// threaded path then runs on any machine, including a single-core one.
+//
+TEST_CASE("for_each_row_batch covers every row once, one batch per thread", "[orientation][threads]")
+{
+  for (const std::size_t Rows : {1u, 2u, 5u, 7u, 64u, 1001u}) {
+    for (const std::size_t Threads : {2u, 3u, 4u, 8u}) {
+      INFO(Rows << " rows on " << Threads << " threads");
+      std::mutex Batches_Mutex;
+      std::vector<std::tuple<std::size_t, std::size_t, std::thread::id>> Batches;
+      for_each_row_batch(
+          Rows, 1,
+          [&](const std::size_t Row_Begin, const std::size_t Row_End) {
+            const std::scoped_lock Lock(Batches_Mutex);
+            Batches.emplace_back(Row_Begin, Row_End, std::this_thread::get_id());
+          },
+          RowBatching{.Min_Batch_Bytes = 1, .Max_Threads = Threads});
+
+      // Batches of ceil(Rows / Threads) rows, the last one possibly shorter, back to back from row 0
+      const auto Batch_Rows = (Rows + std::min(Threads, Rows) - 1) / std::min(Threads, Rows);
+      REQUIRE(Batches.size() == (Rows + Batch_Rows - 1) / Batch_Rows);
+      std::ranges::sort(Batches);
+      std::size_t Next_Row = 0;
+      std::set<std::thread::id> Thread_Ids;
+      for (const auto& [Row_Begin, Row_End, Thread_Id] : Batches) {
+        REQUIRE(Row_Begin == Next_Row);
+        REQUIRE(Row_End > Row_Begin);
+        REQUIRE(Row_End - Row_Begin <= Batch_Rows);
+        Next_Row = Row_End;
+        Thread_Ids.insert(Thread_Id);
+      }
+      REQUIRE(Next_Row == Rows);
+      REQUIRE(Thread_Ids.size() == Batches.size());
+      REQUIRE(std::get<2>(Batches.front()) == std::this_thread::get_id());
+    }
+  }
+}
+
+TEST_CASE("Threaded reflect, flip_vertical and rotate_180 match the single-threaded run", "[orientation][threads]")
+{
+  // Odd heights leave the middle row of rotate_180 next to the last batch
+  for (const std::size_t Height : {1u, 2u, 5u, 7u, 8u, 9u, 33u}) {
+    for (const std::size_t Width : {1u, 17u, 70u}) {
+      for (const std::size_t Threads : {2u, 3u, 4u}) {
+        INFO(Height << "x" << Width << " on " << Threads << " threads");
+        const RowBatching Threaded = {.Min_Batch_Bytes = 1, .Max_Threads = Threads};
+        const auto Original = random_image(Height, Width, static_cast<std::uint32_t>(Height * 1000 + Width));
+
+        auto check = [&](auto apply) {
+          auto Single = Original;
+          auto Batched = Original;
+          auto Single_Span = image_span(Single, Height, Width);
+          auto Batched_Span = image_span(Batched, Height, Width);
+          apply(Single_Span, RowBatching{});
+          apply(Batched_Span, Threaded);
+          REQUIRE(same_pixels(Batched, Single));
+        };
+        check([](auto& Image_Span, const RowBatching Batching) { reflect(Image_Span, Batching); });
+        check([](auto& Image_Span, const RowBatching Batching) { flip_vertical(Image_Span, Batching); });
+        check([](auto& Image_Span, const RowBatching Batching) { rotate_180(Image_Span, Batching); });
+      }
+    }
+  }
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "helpers.hxx"
+#include "planar.hxx"
+#include "test_util.hxx"
+
+using filter::test::image_span;
+using filter::test::random_image;
+using filter::test::same_pixels;
+using filter::test::test_arena;
+
+TEST_CASE("unpack_scanline and pack_scanline round-trip a scanline", "[planar][simd]")
+{
+  // Widths around the 16-pixel SIMD blocks, so both the vector loop and the scalar tail run
+  for (const std::size_t Width : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 47u, 48u, 49u, 63u, 64u, 65u, 100u}) {
+    INFO("Width " << Width);
+    const auto Scanline = random_image(1, Width, static_cast<std::uint32_t>(Width));
+    std::vector<std::uint8_t> Blue(Width), Green(Width), Red(Width);
+    unpack_scanline(Scanline.data(), Width, Blue.data(), Green.data(), Red.data());
+
+    for (std::size_t Col_Pos = 0; Col_Pos < Width; ++Col_Pos) {
+      REQUIRE(Blue[Col_Pos] == Scanline[Col_Pos].rgbtBlue);
+      REQUIRE(Green[Col_Pos] == Scanline[Col_Pos].rgbtGreen);
+      REQUIRE(Red[Col_Pos] == Scanline[Col_Pos].rgbtRed);
+    }
+
+    std::vector<RGBTRIPLE> Packed(Width);
+    pack_scanline(Blue.data(), Green.data(), Red.data(), Width, Packed.data());
+    REQUIRE(same_pixels(Packed, Scanline));
+  }
+}
+
+TEST_CASE("to_planar and from_planar round-trip an image", "[planar]")
+{
+  constexpr std::size_t HEIGHT = 5;
+  constexpr std::size_t WIDTH = 70;  // rows padded to 128 bytes
+  auto Image = random_image(HEIGHT, WIDTH);
+  const auto Original = Image;
+  auto Image_Span = image_span(Image, HEIGHT, WIDTH);
+  auto Arena = test_arena(HEIGHT, WIDTH);
+
+  auto Planar = to_planar(Image_Span, Arena);
+  REQUIRE(Planar.stride() == 128);
+  std::ranges::fill(Image, RGBTRIPLE{});
+  from_planar(Planar, Image_Span);
+  REQUIRE(same_pixels(Image, Original));
+}
+
+////
+/// Every planar overload must produce the bytes of its packed counterpart
+//
+namespace
+{
+auto planar_matches_packed(const std::size_t Height, const std::size_t Width, auto apply_packed, auto apply_planar)
+{
+  auto Packed = random_image(Height, Width, static_cast<std::uint32_t>(Height * 1000 + Width));
+  auto Planar_Result = Packed;
+
+  auto Packed_Span = image_span(Packed, Height, Width);
+  auto Packed_Arena = test_arena(Height, Width);
+  apply_packed(Packed_Span, Packed_Arena);
+
+  auto Planar_Span = image_span(Planar_Result, Height, Width);
+  auto Planar_Arena = test_arena(Height, Width);
+  auto Planar = to_planar(Planar_Span, Planar_Arena);
+  apply_planar(Planar, Planar_Arena);
+  from_planar(Planar, Planar_Span);
+
+  return same_pixels(Packed, Planar_Result);
+}
+
+// Small images, including single rows and columns where every pixel is a border pixel
+constexpr std::array<std::array<std::size_t, 2>, 7> Test_Sizes = {
+    {{1, 1}, {1, 17}, {17, 1}, {2, 2}, {3, 3}, {13, 37}, {32, 65}}};
+}  // namespace
+
+TEST_CASE("planar grey_scale matches the packed filter", "[planar][filters]")
+{
+  for (const auto [Height, Width] : Test_Sizes) {
+    INFO("Image " << Height << "x" << Width);
+    REQUIRE(planar_matches_packed(
+        Height, Width, [](auto& Image, Arena_t&) { grey_scale(Image); },
+        [](PlanarImage& Image, Arena_t&) { grey_scale(Image); }));
+  }
+}
+
+TEST_CASE("planar sepia matches the packed filter", "[planar][filters]")
+{
+  for (const auto [Height, Width] : Test_Sizes) {
+    INFO("Image " << Height << "x" << Width);
+    REQUIRE(planar_matches_packed(
+        Height, Width, [](auto& Image, Arena_t&) { sepia(Image); }, [](PlanarImage& Image, Arena_t&) { sepia(Image); }));
+  }
+}
+
+TEST_CASE("planar blur matches the packed filter", "[planar][filters]")
+{
+  for (const auto [Height, Width] : Test_Sizes) {
+    INFO("Image " << Height << "x" << Width);
+    REQUIRE(planar_matches_packed(
+        Height, Width, [](auto& Image, Arena_t& Scratch) { blur(Image, Scratch); },
+        [](PlanarImage& Image, Arena_t& Scratch) { blur(Image, Scratch); }));
+  }
+}
+
+TEST_CASE("planar edges matches the packed filter", "[planar][filters]")
+{
+  for (const auto [Height, Width] : Test_Sizes) {
+    INFO("Image " << Height << "x" << Width);
+    REQUIRE(planar_matches_packed(
+        Height, Width, [](auto& Image, Arena_t& Scratch) { edges(Image, Scratch); },
+        [](PlanarImage& Image, Arena_t& Scratch) { edges(Image, Scratch); }));
+  }
+}
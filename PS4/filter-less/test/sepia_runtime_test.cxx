@@ -0,0 +1,84 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "helpers.hxx"
+#include "test_util.hxx"
+
+using filter::test::image_span;
+
+////
+/// Pinned output of the packed sepia filter
+//
+// sepia() sums three float products per channel. If the compiler fuses them into FMA instructions (for example
+// with -march=native on an FMA-capable host) the rounding changes and some pixels come out one step off, so the
+// expected bytes below come from the unfused build.
+//
+namespace
+{
+struct SepiaCase
+{
+  RGBTRIPLE In;
+  RGBTRIPLE Out;
+};
+
+// Every case but the first and last rounds differently when the sums are fused
+constexpr std::array Sepia_Cases = {
+    SepiaCase{{0, 0, 0}, {0, 0, 0}},
+    SepiaCase{{0, 90, 20}, {54, 69, 77}},
+    SepiaCase{{0, 138, 139}, {112, 143, 161}},
+    SepiaCase{{0, 189, 54}, {116, 149, 167}},
+    SepiaCase{{1, 22, 1}, {12, 16, 17}},
+    SepiaCase{{1, 119, 2}, {64, 82, 92}},
+    SepiaCase{{1, 212, 100}, {141, 181, 203}},
+    SepiaCase{{2, 59, 7}, {34, 43, 48}},
+    SepiaCase{{255, 255, 255}, {239, 255, 255}},
+};
+
+// FNV-1a over the pixel bytes
+auto fnv1a_64(const std::vector<RGBTRIPLE>& Image)
+{
+  std::uint64_t Hash = 0xcbf29ce484222325;
+  for (const auto& Pixel : Image) {
+    for (const std::uint8_t Byte : {Pixel.rgbtBlue, Pixel.rgbtGreen, Pixel.rgbtRed}) {
+      Hash = (Hash ^ Byte) * 0x100000001b3;
+    }
+  }
+  return Hash;
+}
+}  // namespace
+
+TEST_CASE("Packed sepia rounds exactly as the unfused build", "[sepia]")
+{
+  std::vector<RGBTRIPLE> Image;
+  for (const auto& Case : Sepia_Cases) { Image.push_back(Case.In); }
+  auto Image_Span = image_span(Image, 1, Image.size());
+  sepia(Image_Span);
+
+  for (std::size_t Pos = 0; Pos < Sepia_Cases.size(); ++Pos) {
+    const auto& [In, Out] = Sepia_Cases[Pos];
+    INFO("Pixel " << int{In.rgbtBlue} << "," << int{In.rgbtGreen} << "," << int{In.rgbtRed});
+    REQUIRE(int{Image[Pos].rgbtBlue} == int{Out.rgbtBlue});
+    REQUIRE(int{Image[Pos].rgbtGreen} == int{Out.rgbtGreen});
+    REQUIRE(int{Image[Pos].rgbtRed} == int{Out.rgbtRed});
+  }
+}
+
+TEST_CASE("Packed sepia output is pinned on a 256x256 gradient", "[sepia]")
+{
+  // Blue runs down the rows and green across the columns, so every blue/green pair appears once
+  constexpr std::size_t SIDE = 256;
+  std::vector<RGBTRIPLE> Image(SIDE * SIDE);
+  for (std::size_t Row_Pos = 0; Row_Pos < SIDE; ++Row_Pos) {
+    for (std::size_t Col_Pos = 0; Col_Pos < SIDE; ++Col_Pos) {
+      Image[Row_Pos * SIDE + Col_Pos] = RGBTRIPLE{static_cast<std::uint8_t>(Row_Pos), static_cast<std::uint8_t>(Col_Pos),
+                                                  static_cast<std::uint8_t>(7 * Row_Pos + 13 * Col_Pos)};
+    }
+  }
+  auto Image_Span = image_span(Image, SIDE, SIDE);
+  sepia(Image_Span);
+  REQUIRE(fnv1a_64(Image) == 0x3b0a3f75b4c82986);
+}
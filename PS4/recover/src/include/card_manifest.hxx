@@ -0,0 +1,82 @@
+#ifndef CARD_MANIFEST_HXX
+#define CARD_MANIFEST_HXX
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+////
+/// Ground-truth manifest shared by make_card and recover_bench
+//
+// One line per JPEG written to a synthetic card image:
+//   index,offset,bytes,fnv1a64
+// offset and bytes are in bytes and block aligned; bytes is what recover writes for that JPEG (the JPEG plus
+// its zero padding up to the next block), and fnv1a64 is the FNV-1a hash of exactly those bytes.
+// Lines starting with '#' are comments.
+//
+namespace card
+{
+struct ManifestEntry
+{
+  std::size_t Index;
+  std::uint64_t Offset;
+  std::uint64_t Bytes;
+  std::uint64_t Hash;
+};
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr std::uint64_t FNV_PRIME = 0x100000001b3ull;
+
+// FNV-1a over Bytes, continuing from Hash so a file can be hashed in chunks
+constexpr auto fnv1a_64 = [](const std::span<const std::byte> Bytes, std::uint64_t Hash = FNV_OFFSET_BASIS) noexcept {
+  for (const auto Byte : Bytes) {
+    Hash ^= static_cast<std::uint64_t>(Byte);
+    Hash *= FNV_PRIME;
+  }
+  return Hash;
+};
+
+constexpr auto ManifestEntry_to_string = [](const ManifestEntry& Entry) {
+  return std::format("{},{},{},{:016x}\n", Entry.Index, Entry.Offset, Entry.Bytes, Entry.Hash);
+};
+
+////
+/// Parse a manifest; std::nullopt if the file cannot be opened or a line is malformed
+//
+inline auto read_manifest(const std::filesystem::path& Manifest_Path) -> std::optional<std::vector<ManifestEntry>>
+{
+  std::ifstream Manifest(Manifest_Path);
+  if (!Manifest.is_open()) { return std::nullopt; }
+
+  std::vector<ManifestEntry> Entries;
+  std::string Line;
+  while (std::getline(Manifest, Line)) {
+    if (Line.empty() || Line.front() == '#') { continue; }
+
+    ManifestEntry Entry = {};
+    const char* Pos = Line.data();
+    const char* End = Line.data() + Line.size();
+    auto parse_field = [&](auto& Field, const int Base, const bool Last) {
+      const auto [Ptr, Error] = std::from_chars(Pos, End, Field, Base);
+      if (Error != std::errc{} || (Last ? Ptr != End : Ptr == End || *Ptr != ',')) { return false; }
+      Pos = Last ? Ptr : Ptr + 1;
+      return true;
+    };
+    if (!parse_field(Entry.Index, 10, false) || !parse_field(Entry.Offset, 10, false) ||
+        !parse_field(Entry.Bytes, 10, false) || !parse_field(Entry.Hash, 16, true)) {
+      return std::nullopt;
+    }
+    Entries.push_back(Entry);
+  }
+  return Entries;
+}
+}  // namespace card
+#endif  // CARD_MANIFEST_HXX
@@ -0,0 +1,108 @@
+#ifndef RECOVER_HXX
+#define RECOVER_HXX
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <span>
+
+namespace recover
+{
+constexpr std::size_t FAT_BLOCK_SIZE = 512;  // FAT format block size
+
+// utility lambdas remove error prone reinterpret casts from code replace with safer bit_cast
+constexpr auto const_byte_ptr_to_const_char_ptr = [](const std::byte* Ptr) noexcept {
+  return std::bit_cast<const char*>(Ptr);
+};
+constexpr auto byte_ptr_to_char_ptr = [](std::byte* Ptr) noexcept {
+  return std::bit_cast<char*>(Ptr);
+};
+
+constexpr auto is_jpeg_header = [](const auto& JPEG_Block) noexcept {
+  return JPEG_Block[0] == std::byte{0xff} && JPEG_Block[1] == std::byte{0xd8} && JPEG_Block[2] == std::byte{0xff} &&
+                 (JPEG_Block[3] & std::byte{0xf0}) == std::byte{0xe0}
+             ? true
+             : false;
+};
+
+constexpr auto read_block = [](auto& FAT_Block, std::ifstream& Raw_Disk_Image) {
+  // Read a FAT conformant block From rawImage
+  return Raw_Disk_Image.read(byte_ptr_to_char_ptr(FAT_Block.data()), FAT_Block.size()) && Raw_Disk_Image.good() ? true
+                                                                                                                : false;
+};
+
+constexpr auto write_block = [](const auto& JPEG_Block, std::ofstream& JPEG_File) {
+  // Write a JPEG_Block to JPEG_File
+  return JPEG_File.write(const_byte_ptr_to_const_char_ptr(JPEG_Block.data()), JPEG_Block.size()) && JPEG_File.good()
+             ? true
+             : false;
+};
+
+// Name of the N-th recovered JPEG: 000.jpg, 001.jpg, ...
+constexpr auto JPEG_filename = [](const std::size_t JPEG_FileNumber) {
+  return std::format("{:0>3}.jpg", JPEG_FileNumber);
+};
+
+////
+/// Carve every JPEG out of Disk_Image_FAT into Output_Dir
+//
+// Returns the number of JPEGs found, or std::nullopt if a JPEG file could not be opened or written.
+//
+inline auto recover_jpegs(std::ifstream& Disk_Image_FAT, const std::filesystem::path& Output_Dir = ".")
+    -> std::optional<std::size_t>
+{
+  // Static to ensure allocation in static storage, not on the runtime stack
+  static std::array<std::byte, FAT_BLOCK_SIZE> FAT_Block = {};
+
+  std::size_t JPEG_FileNumber = 0;
+  std::ofstream JPEG_File;
+
+  auto Current_Block = std::span{FAT_Block};
+
+  while (read_block(Current_Block, Disk_Image_FAT)) {
+    // Possible states
+    //   initial state:
+    //     no open files -> must still be in FAT
+    //   JPEG Recovery state:
+    //     Block is a jpeg header -> start of new JPEG
+    //       if OutputFile is open close it.
+    //       Open Outputfile Write header
+    //   JPEG Block Recovery state: We have OpenFile must be JPEG block. Write it.
+
+    if (is_jpeg_header(Current_Block)) {
+      // initial state -> JPEG Recovery state: Done with FAT. JPEG recovery begins
+      // or
+      // JPEG Block Recovery state -> JPEG Recovery state:
+
+      if (JPEG_File.is_open()) {
+        // JPEG Block Recovery state -> JPEG Recovery state: We are done with the currently open file. Close it.
+
+        JPEG_File.close();
+      }
+      JPEG_File.open(Output_Dir / JPEG_filename(JPEG_FileNumber), std::ios::binary);
+      if (!JPEG_File.is_open() || !JPEG_File.good()) {
+        // JPEG Recovery state -> JPEG Block Recovery state: Open a new file for the new JPEG
+
+        std::println("Could not open {}", JPEG_filename(JPEG_FileNumber));
+        return std::nullopt;  // Exit if the new file cannot be opened
+      }
+      ++JPEG_FileNumber;  // Increment the file counter for the next JPEG
+    }
+
+    if (JPEG_File.is_open()) [[likely]] {
+      // JPEG Block Recovery state: Write the current block to the open JPEG file
+
+      if (!write_block(Current_Block, JPEG_File)) [[unlikely]] {
+        return std::nullopt;  // Exit if writing a block to the file fails
+      }
+    }
+  }
+  if (JPEG_File.is_open()) { JPEG_File.close(); }  // redundant because RAII
+  return JPEG_FileNumber;
+}
+}  // namespace recover
+#endif  // RECOVER_HXX
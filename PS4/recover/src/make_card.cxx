@@ -0,0 +1,290 @@
+// Synthetic FAT-style raw image generator for recover
+#include <getopt.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <print>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "include/card_manifest.hxx"
+#include "include/recover.hxx"
+
+////
+/// Writes a deterministic raw card image for benchmarking recover:
+///   - Slack_Blocks zero blocks (the FAT area recover has to skip),
+///   - followed by JPEGs back to back, each starting on a block boundary with an FF D8 FF Ex header, filled with
+///     pseudo-random bytes, ending in FF D9 and zero padded to the next block.
+/// No payload block starts with a JPEG signature, so recover must find exactly the JPEGs listed in the manifest.
+/// The same options and seed always produce the same image.
+//
+namespace make_card
+{
+enum class SizeDistribution : std::uint8_t
+{
+  FIXED,
+  UNIFORM,
+  LOGNORMAL
+};
+
+struct Options
+{
+  std::filesystem::path Image_Path;
+  std::filesystem::path Manifest_Path;
+  std::optional<std::size_t> JPEG_Count;                        // -n
+  std::optional<double> Target_GiB;                             // -g
+  std::size_t Mean_KiB = 256;                                   // -m
+  SizeDistribution Distribution = SizeDistribution::LOGNORMAL;  // -d
+  std::size_t Slack_Blocks = 2048;                              // -z, 1 MiB
+  std::uint64_t Seed = 50;                                      // -s
+};
+
+constexpr std::size_t BLOCK_SIZE = recover::FAT_BLOCK_SIZE;
+constexpr std::size_t MIN_JPEG_BYTES = 6;  // header and end marker
+constexpr std::size_t MIB = std::size_t{1} << 20;
+
+constexpr auto string_view_to_SizeDistribution =
+    [](const std::string_view Name) noexcept -> std::optional<SizeDistribution> {
+  if (Name == "fixed") { return SizeDistribution::FIXED; }
+  if (Name == "uniform") { return SizeDistribution::UNIFORM; }
+  if (Name == "lognormal") { return SizeDistribution::LOGNORMAL; }
+  return std::nullopt;
+};
+
+////
+/// Draw JPEG sizes in bytes with the requested distribution and mean
+//
+class JPEGSizer
+{
+private:
+  SizeDistribution Distribution_;
+  double Mean_Bytes_;
+  std::uniform_real_distribution<double> Uniform_;
+  std::lognormal_distribution<double> Lognormal_;
+
+public:
+  static constexpr double LOGNORMAL_SIGMA = 0.5;
+
+  JPEGSizer(const SizeDistribution Distribution, const double Mean_Bytes)
+    : Distribution_(Distribution),
+      Mean_Bytes_(Mean_Bytes),
+      Uniform_(Mean_Bytes / 2.0, Mean_Bytes * 1.5),
+      // mu chosen so that the mean, not the median, equals Mean_Bytes
+      Lognormal_(std::log(Mean_Bytes) - LOGNORMAL_SIGMA * LOGNORMAL_SIGMA / 2.0, LOGNORMAL_SIGMA)
+  {
+  }
+
+  auto operator()(std::mt19937_64& Engine) -> std::size_t
+  {
+    double Bytes = Mean_Bytes_;
+    switch (Distribution_) {
+      case SizeDistribution::FIXED:
+        break;
+      case SizeDistribution::UNIFORM:
+        Bytes = Uniform_(Engine);
+        break;
+      case SizeDistribution::LOGNORMAL:
+        Bytes = Lognormal_(Engine);
+        break;
+    }
+    return std::max(MIN_JPEG_BYTES, static_cast<std::size_t>(Bytes));
+  }
+};
+
+////
+/// Fill Buffer with one block-padded synthetic JPEG of JPEG_Bytes bytes
+//
+auto fill_jpeg(std::vector<std::byte>& Buffer, const std::size_t JPEG_Bytes, std::mt19937_64& Engine) -> void
+{
+  const std::size_t Blocks = (JPEG_Bytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  Buffer.assign(Blocks * BLOCK_SIZE, std::byte{0});
+
+  // Pseudo-random payload, eight bytes per draw
+  for (std::size_t Pos = 0; Pos < JPEG_Bytes; Pos += sizeof(std::uint64_t)) {
+    const std::uint64_t Word = Engine();
+    std::memcpy(Buffer.data() + Pos, &Word, std::min(sizeof(Word), JPEG_Bytes - Pos));
+  }
+
+  // A payload block must never look like the start of another JPEG
+  for (std::size_t Block = 1; Block < Blocks; ++Block) {
+    auto Current_Block = std::span{Buffer}.subspan(Block * BLOCK_SIZE, BLOCK_SIZE);
+    if (recover::is_jpeg_header(Current_Block)) { Current_Block[0] = std::byte{0x00}; }
+  }
+
+  // SOI + APPn marker, EOI at the end
+  Buffer[0] = std::byte{0xff};
+  Buffer[1] = std::byte{0xd8};
+  Buffer[2] = std::byte{0xff};
+  Buffer[3] = std::byte{0xe0} | static_cast<std::byte>(Engine() & 0x0f);
+  Buffer[JPEG_Bytes - 2] = std::byte{0xff};
+  Buffer[JPEG_Bytes - 1] = std::byte{0xd9};
+}
+
+auto print_usage() -> void
+{
+  std::println("Usage: ./make_card [-n count | -g GiB] [-m mean_KiB] [-d fixed|uniform|lognormal] [-z slack_blocks] "
+               "[-s seed] image.raw [manifest.csv]");
+  std::println("  -n  number of JPEGs (default 1000 unless -g is given)");
+  std::println("  -g  keep adding JPEGs until the image reaches this many GiB");
+  std::println("  -m  mean JPEG size in KiB (default 256)");
+  std::println("  -d  JPEG size distribution (default lognormal, sigma 0.5)");
+  std::println("  -z  zero blocks before the first JPEG (default 2048)");
+  std::println("  -s  random seed (default 50)");
+  std::println("  The manifest defaults to image.raw.manifest");
+}
+
+auto parse_options(int argc, char* argv[]) -> std::optional<Options>
+{
+  Options Parsed;
+  auto string_to_uint64 = [](const char* Text) -> std::optional<std::uint64_t> {
+    char* End = nullptr;
+    const auto Value = std::strtoull(Text, &End, 10);
+    return End != Text && *End == '\0' ? std::optional{static_cast<std::uint64_t>(Value)} : std::nullopt;
+  };
+
+  for (int Option = 0; (Option = getopt(argc, argv, "n:g:m:d:z:s:h")) != -1;) {
+    switch (Option) {
+      case 'n': {
+        const auto Value = string_to_uint64(optarg);
+        if (!Value) { return std::nullopt; }
+        Parsed.JPEG_Count = *Value;
+      } break;
+      case 'g': {
+        char* End = nullptr;
+        const double Value = std::strtod(optarg, &End);
+        if (End == optarg || *End != '\0' || !(Value > 0.0)) { return std::nullopt; }
+        Parsed.Target_GiB = Value;
+      } break;
+      case 'm': {
+        const auto Value = string_to_uint64(optarg);
+        if (!Value || *Value == 0) { return std::nullopt; }
+        Parsed.Mean_KiB = *Value;
+      } break;
+      case 'd': {
+        const auto Value = string_view_to_SizeDistribution(optarg);
+        if (!Value) { return std::nullopt; }
+        Parsed.Distribution = *Value;
+      } break;
+      case 'z': {
+        // The slack is written as Slack_Blocks * BLOCK_SIZE bytes, which has to fit in 64 bits
+        const auto Value = string_to_uint64(optarg);
+        if (!Value || *Value > std::numeric_limits<std::uint64_t>::max() / BLOCK_SIZE) { return std::nullopt; }
+        Parsed.Slack_Blocks = *Value;
+      } break;
+      case 's': {
+        const auto Value = string_to_uint64(optarg);
+        if (!Value) { return std::nullopt; }
+        Parsed.Seed = *Value;
+      } break;
+      default:
+        return std::nullopt;
+    }
+  }
+
+  if (argc - optind < 1 || argc - optind > 2 || (Parsed.JPEG_Count && Parsed.Target_GiB)) { return std::nullopt; }
+  Parsed.Image_Path = argv[optind];
+  Parsed.Manifest_Path = Parsed.Image_Path;
+  if (argc - optind == 2) { Parsed.Manifest_Path = argv[optind + 1]; }
+  else { Parsed.Manifest_Path += ".manifest"; }
+  if (!Parsed.JPEG_Count && !Parsed.Target_GiB) { Parsed.JPEG_Count = 1000; }
+  return Parsed;
+}
+}  // namespace make_card
+
+int main(int argc, char* argv[])
+{
+  using namespace make_card;
+
+  const auto Parsed = parse_options(argc, argv);
+  if (!Parsed) {
+    print_usage();
+    return 1;
+  }
+  const auto& Opts = *Parsed;
+
+  std::ofstream Image(Opts.Image_Path, std::ios::binary);
+  std::ofstream Manifest(Opts.Manifest_Path);
+  if (!Image.is_open() || !Manifest.is_open()) {
+    std::println("Could not create {} or {}.", Opts.Image_Path.string(), Opts.Manifest_Path.string());
+    return 2;
+  }
+
+  auto write_bytes = [&](const std::span<const std::byte> Bytes) {
+    return Image.write(recover::const_byte_ptr_to_const_char_ptr(Bytes.data()),
+                       static_cast<std::streamsize>(Bytes.size())) &&
+           Image.good();
+  };
+  auto write_manifest = [&](const std::string_view Line) { return (Manifest << Line) && Manifest.good(); };
+
+  if (!write_manifest(std::format("# make_card seed={} mean_KiB={} slack_blocks={}\n", Opts.Seed, Opts.Mean_KiB,
+                                  Opts.Slack_Blocks)) ||
+      !write_manifest("# index,offset,bytes,fnv1a64\n")) {
+    std::println("Could not write {}.", Opts.Manifest_Path.string());
+    return 3;
+  }
+
+  // Slack: the FAT area before the first JPEG
+  std::uint64_t Offset = 0;
+  {
+    const std::vector<std::byte> Zero_Chunk(MIB, std::byte{0});
+    for (std::uint64_t Remaining = Opts.Slack_Blocks * BLOCK_SIZE; Remaining > 0;) {
+      const auto Length = std::min<std::uint64_t>(Remaining, Zero_Chunk.size());
+      if (!write_bytes(std::span{Zero_Chunk}.first(Length))) {
+        std::println("Could not write {}.", Opts.Image_Path.string());
+        return 3;
+      }
+      Remaining -= Length;
+      Offset += Length;
+    }
+  }
+
+  // JPEGs
+  std::mt19937_64 Engine(Opts.Seed);
+  JPEGSizer JPEG_Sizer(Opts.Distribution, static_cast<double>(Opts.Mean_KiB) * 1024.0);
+  std::vector<std::byte> JPEG_Buffer;
+
+  const auto Target_Bytes =
+      Opts.Target_GiB ? static_cast<std::uint64_t>(*Opts.Target_GiB * 1024.0 * 1024.0 * 1024.0) : std::uint64_t{0};
+  auto more_jpegs = [&](const std::size_t Written) {
+    return Opts.JPEG_Count ? Written < *Opts.JPEG_Count : Offset < Target_Bytes;
+  };
+
+  std::size_t JPEG_Count = 0;
+  for (; more_jpegs(JPEG_Count); ++JPEG_Count) {
+    fill_jpeg(JPEG_Buffer, JPEG_Sizer(Engine), Engine);
+    if (!write_bytes(JPEG_Buffer)) {
+      std::println("Could not write {}.", Opts.Image_Path.string());
+      return 3;
+    }
+    if (!write_manifest(
+            card::ManifestEntry_to_string({JPEG_Count, Offset, JPEG_Buffer.size(), card::fnv1a_64(JPEG_Buffer)}))) {
+      std::println("Could not write {}.", Opts.Manifest_Path.string());
+      return 3;
+    }
+    Offset += JPEG_Buffer.size();
+  }
+
+  // Buffered bytes only reach the files here, so a full disk can still fail
+  if (!Image.flush()) {
+    std::println("Could not write {}.", Opts.Image_Path.string());
+    return 3;
+  }
+  if (!Manifest.flush()) {
+    std::println("Could not write {}.", Opts.Manifest_Path.string());
+    return 3;
+  }
+
+  std::println("Wrote {} JPEGs, {:.3f} GiB to {}", JPEG_Count, static_cast<double>(Offset) / (1024.0 * MIB),
+               Opts.Image_Path.string());
+  return 0;
+}
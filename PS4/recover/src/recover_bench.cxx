@@ -0,0 +1,206 @@
+// Throughput benchmark for the recover engine
+#include <getopt.h>
+#include <sys/resource.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "include/card_manifest.hxx"
+#include "include/recover.hxx"
+
+////
+/// Runs recover::recover_jpegs() on a card image written by make_card and reports
+///   - throughput in GB/s (10^9 bytes of card image per second),
+///   - read and write syscalls per GB, from /proc/self/io,
+///   - peak resident set size of the process,
+/// then checks every recovered JPEG against the make_card manifest (count, size and FNV-1a hash).
+/// The card image is read through the page cache; run it twice, or drop the caches, to choose warm or cold.
+//
+namespace recover_bench
+{
+struct Options
+{
+  std::filesystem::path Image_Path;
+  std::filesystem::path Manifest_Path;
+  std::filesystem::path Output_Dir = std::filesystem::temp_directory_path() / "recover_bench_jpegs";
+  bool Keep = false;  // keep the recovered JPEGs
+};
+
+struct SyscallCounts
+{
+  std::uint64_t Reads;
+  std::uint64_t Writes;
+};
+
+////
+/// read(2)- and write(2)-family syscalls issued by this process so far
+//
+auto read_syscall_counts() -> std::optional<SyscallCounts>
+{
+  std::ifstream Proc_Io("/proc/self/io");
+  if (!Proc_Io.is_open()) { return std::nullopt; }
+
+  std::optional<std::uint64_t> Reads;
+  std::optional<std::uint64_t> Writes;
+  std::string Key;
+  std::uint64_t Value = 0;
+  while (Proc_Io >> Key >> Value) {
+    if (Key == "syscr:") { Reads = Value; }
+    if (Key == "syscw:") { Writes = Value; }
+  }
+  if (!Reads || !Writes) { return std::nullopt; }
+  return SyscallCounts{*Reads, *Writes};
+}
+
+////
+/// Size and FNV-1a hash of a recovered file
+//
+auto hash_file(const std::filesystem::path& File_Path) -> std::optional<std::pair<std::uint64_t, std::uint64_t>>
+{
+  std::ifstream File(File_Path, std::ios::binary);
+  if (!File.is_open()) { return std::nullopt; }
+
+  static std::array<std::byte, std::size_t{1} << 16> Chunk = {};
+  std::uint64_t Bytes = 0;
+  std::uint64_t Hash = card::FNV_OFFSET_BASIS;
+  while (File.read(recover::byte_ptr_to_char_ptr(Chunk.data()), Chunk.size()) || File.gcount() > 0) {
+    const auto Length = static_cast<std::size_t>(File.gcount());
+    Hash = card::fnv1a_64(std::span{Chunk}.first(Length), Hash);
+    Bytes += Length;
+  }
+  return std::pair{Bytes, Hash};
+}
+
+auto print_usage() -> void
+{
+  std::println("Usage: ./recover_bench [-o output_dir] [-k] image.raw [manifest.csv]");
+  std::println("  -o  new or empty directory for the recovered JPEGs (default <tmp>/recover_bench_jpegs)");
+  std::println("  -k  keep the recovered JPEGs");
+  std::println("  The manifest defaults to image.raw.manifest");
+}
+
+auto parse_options(int argc, char* argv[]) -> std::optional<Options>
+{
+  Options Parsed;
+  for (int Option = 0; (Option = getopt(argc, argv, "o:kh")) != -1;) {
+    switch (Option) {
+      case 'o':
+        Parsed.Output_Dir = optarg;
+        break;
+      case 'k':
+        Parsed.Keep = true;
+        break;
+      default:
+        return std::nullopt;
+    }
+  }
+
+  if (argc - optind < 1 || argc - optind > 2) { return std::nullopt; }
+  Parsed.Image_Path = argv[optind];
+  Parsed.Manifest_Path = Parsed.Image_Path;
+  if (argc - optind == 2) { Parsed.Manifest_Path = argv[optind + 1]; }
+  else { Parsed.Manifest_Path += ".manifest"; }
+  return Parsed;
+}
+}  // namespace recover_bench
+
+int main(int argc, char* argv[])
+{
+  using namespace recover_bench;
+
+  const auto Parsed = parse_options(argc, argv);
+  if (!Parsed) {
+    print_usage();
+    return 1;
+  }
+  const auto& Opts = *Parsed;
+
+  const auto Manifest = card::read_manifest(Opts.Manifest_Path);
+  if (!Manifest) {
+    std::println("Could not read manifest {}.", Opts.Manifest_Path.string());
+    return 2;
+  }
+
+  // Never mix the recovered JPEGs with existing files
+  std::error_code Error;
+  std::filesystem::create_directories(Opts.Output_Dir, Error);
+  if (Error || !std::filesystem::is_empty(Opts.Output_Dir, Error)) {
+    std::println("{} must be a new or empty directory.", Opts.Output_Dir.string());
+    return 2;
+  }
+
+  const auto Image_Bytes = std::filesystem::file_size(Opts.Image_Path, Error);
+  std::ifstream Disk_Image_FAT(Opts.Image_Path, std::ios::binary);
+  if (Error || !Disk_Image_FAT.is_open()) {
+    std::println("File {} could not be opened.", Opts.Image_Path.string());
+    return 2;
+  }
+
+  ////
+  /// Timed run of the engine
+  //
+  const auto Syscalls_Before = read_syscall_counts();
+  const auto Start = std::chrono::steady_clock::now();
+  const auto JPEG_Count = recover::recover_jpegs(Disk_Image_FAT, Opts.Output_Dir);
+  const auto Stop = std::chrono::steady_clock::now();
+  const auto Syscalls_After = read_syscall_counts();
+
+  if (!JPEG_Count) {
+    std::println("Recovery failed.");
+    return 3;
+  }
+
+  rusage Usage = {};
+  getrusage(RUSAGE_SELF, &Usage);
+
+  const double Seconds = std::chrono::duration<double>(Stop - Start).count();
+  const double Image_GB = static_cast<double>(Image_Bytes) / 1e9;
+
+  std::println("Image          : {} ({:.3f} GB)", Opts.Image_Path.string(), Image_GB);
+  std::println("JPEGs          : {} found, {} expected", *JPEG_Count, Manifest->size());
+  std::println("Time           : {:.3f} s", Seconds);
+  std::println("Throughput     : {:.3f} GB/s", Image_GB / Seconds);
+  if (Syscalls_Before && Syscalls_After) {
+    const auto Reads = Syscalls_After->Reads - Syscalls_Before->Reads;
+    const auto Writes = Syscalls_After->Writes - Syscalls_Before->Writes;
+    std::println("Read syscalls  : {:.0f} per GB", static_cast<double>(Reads) / Image_GB);
+    std::println("Write syscalls : {:.0f} per GB", static_cast<double>(Writes) / Image_GB);
+  }
+  else {
+    std::println("Syscalls       : /proc/self/io not available");
+  }
+  std::println("Peak RSS       : {:.1f} MiB", static_cast<double>(Usage.ru_maxrss) / 1024.0);
+
+  ////
+  /// Check the recovered files against the manifest
+  //
+  std::size_t Mismatches = *JPEG_Count == Manifest->size() ? 0 : 1;
+  for (const auto& Entry : *Manifest) {
+    const auto JPEG_Path = Opts.Output_Dir / recover::JPEG_filename(Entry.Index);
+    const auto Recovered = hash_file(JPEG_Path);
+    if (!Recovered || Recovered->first != Entry.Bytes || Recovered->second != Entry.Hash) [[unlikely]] {
+      if (Mismatches < 10) { std::println("Mismatch       : {}", JPEG_Path.string()); }
+      ++Mismatches;
+    }
+  }
+  std::println("Verification   : {}", Mismatches == 0 ? "OK" : "FAILED");
+
+  if (!Opts.Keep) {
+    // Only remove what the run wrote
+    for (std::size_t JPEG_FileNumber = 0; JPEG_FileNumber < *JPEG_Count; ++JPEG_FileNumber) {
+      std::filesystem::remove(Opts.Output_Dir / recover::JPEG_filename(JPEG_FileNumber), Error);
+    }
+    std::filesystem::remove(Opts.Output_Dir, Error);  // succeeds only if now empty
+  }
+  return Mismatches == 0 ? 0 : 4;
+}